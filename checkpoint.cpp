@@ -0,0 +1,132 @@
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+#include <numeric>
+#include <unordered_map>
+#include "checkpoint.h"
+#include "results.h"
+
+namespace checkpoint {
+    const char magic[4] = {'P', 'R', 'C', 'K'};
+    const uint32_t version = 2;
+
+    template<typename T>
+    static void write_field(std::ofstream &file, const T &value) {
+        file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    static bool read_field(std::ifstream &file, T &value) {
+        return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+    }
+
+    bool read(const std::string &filename, state &s) {
+        std::ifstream file(filename, std::ios::in | std::ios::binary);
+        if (!file.is_open())
+            return false;
+
+        char file_magic[4];
+        uint32_t file_version;
+        uint64_t n;
+        if (!file.read(file_magic, sizeof(file_magic)) || !std::equal(magic, magic + 4, file_magic) ||
+            !read_field(file, file_version) || file_version != version)
+            return false;
+
+        if (!read_field(file, s.fingerprint) || !read_field(file, s.iteration) || !read_field(file, s.residual) ||
+            !read_field(file, s.beta) || !read_field(file, s.tolerance) || !read_field(file, s.finished) ||
+            !read_field(file, n))
+            return false;
+
+        s.r.resize(n);
+        return static_cast<bool>(file.read(reinterpret_cast<char *>(s.r.data()),
+                                           static_cast<std::streamsize>(n * sizeof(float))));
+    }
+
+    void write(const std::string &filename, const state &s) {
+        std::string tmp_filename = filename + ".tmp";
+        std::ofstream file(tmp_filename, std::ios::out | std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: cannot open file " << tmp_filename << std::endl;
+            return;
+        }
+
+        file.write(magic, sizeof(magic));
+        write_field(file, version);
+        write_field(file, s.fingerprint);
+        write_field(file, s.iteration);
+        write_field(file, s.residual);
+        write_field(file, s.beta);
+        write_field(file, s.tolerance);
+        write_field(file, s.finished);
+        write_field(file, static_cast<uint64_t>(s.r.size()));
+        file.write(reinterpret_cast<const char *>(s.r.data()),
+                   static_cast<std::streamsize>(s.r.size() * sizeof(float)));
+        file.close();
+
+        if (!file || std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
+            std::cerr << "Error: cannot write checkpoint " << filename << std::endl;
+    }
+
+    std::vector<float> warm_start(const std::string &results_filename, const std::vector<unsigned int> &original_ids) {
+        std::vector<std::pair<unsigned int, float>> records;
+        if (!results::read_binary(results_filename, records))
+            return {};
+
+        std::unordered_map<unsigned int, float> previous(records.begin(), records.end());
+
+        // new nodes start from the uniform value, then everything is rescaled to a distribution
+        size_t n = original_ids.size();
+        std::vector<float> v(n);
+        for (size_t i = 0; i < n; ++i) {
+            auto it = previous.find(original_ids[i]);
+            v[i] = it != previous.end() ? it->second : static_cast<float>(1) / n;
+        }
+
+        double sum = std::accumulate(v.begin(), v.end(), 0.0);
+        if (sum <= 0)
+            return {};
+        for (auto &x: v)
+            x = static_cast<float>(x / sum);
+
+        return v;
+    }
+
+    writer::writer(const std::string &filename) : filename(filename), thread(&writer::loop, this) {}
+
+    writer::~writer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_one();
+        thread.join();
+    }
+
+    void writer::submit(const state &s) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending = s;
+            has_pending = true;
+        }
+        cv.notify_one();
+    }
+
+    void writer::loop() {
+        state current;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [this] { return has_pending || stopping; });
+                if (!has_pending)
+                    return;
+
+                std::swap(current, pending);
+                has_pending = false;
+            }
+
+            write(filename, current);
+        }
+    }
+}
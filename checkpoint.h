@@ -0,0 +1,58 @@
+#ifndef ASSIGNMENT_1_LMD_CHECKPOINT_H
+#define ASSIGNMENT_1_LMD_CHECKPOINT_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// solver state saved periodically during long solves, so that they can be resumed after a preemption
+namespace checkpoint {
+    struct state {
+        uint64_t fingerprint = 0; // graph::get_fingerprint of the graph being ranked
+        uint32_t iteration = 0;
+        float residual = 0;
+        float beta = 0;
+        double tolerance = 0;
+        uint8_t finished = 0;     // 1 once the solve converged or ran out of iterations: nothing left to resume
+        std::vector<float> r;
+    };
+
+    // binary format: "PRCK", uint32 version, the fields of state in order, uint64 n, n floats; returns false if the
+    // file is missing or not a valid checkpoint
+    bool read(const std::string &filename, state &s);
+
+    // writes to filename + ".tmp" and renames it, so a preemption during the write keeps the previous checkpoint
+    void write(const std::string &filename, const state &s);
+
+    // starting vector for the nodes in original_ids (as returned by utility::parse_edges_from_file_and_normalize)
+    // from the ranks of a previous run saved by results::write_binary; nodes unknown to the previous run get the
+    // uniform value and the vector is normalized. Returns an empty vector if the file cannot be read
+    std::vector<float> warm_start(const std::string &results_filename, const std::vector<unsigned int> &original_ids);
+
+    // background writer: submit copies the state and returns, the file is written by a separate thread; if a write
+    // is still in progress only the most recent state is kept
+    class writer {
+    private:
+        std::string filename;
+        state pending;
+        bool has_pending = false, stopping = false;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::thread thread;
+
+        void loop();
+
+    public:
+        explicit writer(const std::string &filename);
+
+        // writes the last submitted state, if any, before returning
+        ~writer();
+
+        void submit(const state &s);
+    };
+}
+
+#endif //ASSIGNMENT_1_LMD_CHECKPOINT_H
@@ -7,6 +7,7 @@
 #include <set>
 #include "graph.h"
 #include "../utility.h"
+#include "../checkpoint.h"
 
 graph::graph(const unsigned int &n, const std::vector<std::pair<unsigned int, unsigned int>> &edges)
         : n(n), m(edges.size()) {
@@ -64,7 +65,7 @@ unsigned int graph::get_n() const {
     return n;
 }
 
-unsigned int graph::get_m() const {
+size_t graph::get_m() const {
     return m;
 }
 
@@ -99,6 +100,39 @@ void graph::print(unsigned int max_n) const {
     std::cout << std::endl;
 }
 
+// splitmix64 finalizer
+static inline uint64_t mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t graph::get_fingerprint() const {
+    // sum of the hashes of the edges, so that the order of the input file does not matter
+    uint64_t edges_hash = 0;
+
+#pragma omp parallel for default(none) shared(col_ids, n) reduction(+:edges_hash)
+    for (unsigned int i = 0; i < n; ++i) {
+        if (col_ids[i] != nullptr) {
+            for (auto &j: *col_ids[i])
+                edges_hash += mix((static_cast<uint64_t>(i) << 32) | j);
+        }
+    }
+
+    return mix(mix(n) ^ edges_hash);
+}
+
+uint64_t
+graph::get_fingerprint(const unsigned int &n, const std::vector<std::pair<unsigned int, unsigned int>> &edges) {
+    uint64_t edges_hash = 0;
+
+#pragma omp parallel for default(none) shared(edges) reduction(+:edges_hash)
+    for (size_t e = 0; e < edges.size(); ++e)
+        edges_hash += mix((static_cast<uint64_t>(edges[e].first) << 32) | edges[e].second);
+
+    return mix(mix(n) ^ edges_hash);
+}
+
 std::vector<float>
 graph::seq_page_rank(const std::vector<float> &v, float beta, unsigned int max_iterations, double tolerance) const {
     std::vector<float> r(v), r_new(v);
@@ -139,7 +173,7 @@ graph::seq_page_rank(const std::vector<float> &v, float beta, unsigned int max_i
 
 std::vector<float>
 graph::par_page_rank(const std::vector<float> &v, float beta, unsigned int max_iterations, double tolerance,
-                     int n_thread) const {
+                     int n_thread, int chunk_size) const {
     std::vector<float> r(v), r_new(v);
     unsigned int iterations = 0;
     float sum;
@@ -149,6 +183,11 @@ graph::par_page_rank(const std::vector<float> &v, float beta, unsigned int max_i
         n_thread = omp_get_max_threads();
     }
 
+    // If chunk_size is -1, use about n_thread times the average degree
+    if (chunk_size == -1) {
+        chunk_size = std::max(1, int(n_thread * m / n));
+    }
+
 #pragma omp ordered
     do {
         r = r_new;
@@ -156,7 +195,7 @@ graph::par_page_rank(const std::vector<float> &v, float beta, unsigned int max_i
         float r_sum_dead_ends = 0;
 
 #pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
-        shared(r, r_new, col_ids, n, m, n_thread) schedule(dynamic, int(n_thread * m/n)) \
+        shared(r, r_new, col_ids, n, chunk_size) schedule(dynamic, chunk_size) \
         reduction(+:r_sum_dead_ends)
 
         for (unsigned int i = 0; i < n; ++i) {
@@ -195,3 +234,794 @@ graph::par_page_rank(const std::vector<float> &v, float beta, unsigned int max_i
 
     return r_new;
 }
+
+float graph::page_rank_sweep(const std::vector<float> &r, std::vector<float> &r_new, float beta,
+                             const std::vector<float> *teleport, int n_thread) const {
+    // about n_thread times the average degree, at least 1
+    int chunk_size = std::max(1, int(n_thread * m / n));
+
+    std::fill(r_new.begin(), r_new.end(), 0.0);
+    float r_sum_dead_ends = 0;
+
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+        shared(r, r_new, col_ids, n, chunk_size) schedule(dynamic, chunk_size) \
+        reduction(+:r_sum_dead_ends)
+
+    for (unsigned int i = 0; i < n; ++i) {
+        if (col_ids[i] == nullptr)
+            r_sum_dead_ends += r[i];
+        else {
+            float r_i_divided = r[i] / static_cast<float>(col_ids[i]->size());
+            for (auto &j: *col_ids[i]) {
+#pragma omp atomic update
+                r_new[j] += r_i_divided;
+            }
+        }
+    }
+
+    float sum = 0;
+    if (teleport == nullptr) {
+        // apply teleportation and add all dead ends to each node
+        float teleportation_correction = (1 - beta) / static_cast<float>(n);
+        float dead_end_weight = r_sum_dead_ends / static_cast<float>(n);
+
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+        firstprivate(beta, dead_end_weight, teleportation_correction) shared(r, r_new, n) \
+        reduction(+:sum)
+
+        for (unsigned int i = 0; i < n; ++i) {
+            r_new[i] = (r_new[i] + dead_end_weight) * beta + teleportation_correction;
+            sum += static_cast<float>(std::pow(r_new[i] - r[i], 2));
+        }
+    } else {
+        // apply teleportation and add all dead ends, both following the teleport distribution
+        const std::vector<float> &t = *teleport;
+
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+        firstprivate(beta, r_sum_dead_ends) shared(r, r_new, t, n) \
+        reduction(+:sum)
+
+        for (unsigned int i = 0; i < n; ++i) {
+            r_new[i] = (r_new[i] + r_sum_dead_ends * t[i]) * beta + (1 - beta) * t[i];
+            sum += static_cast<float>(std::pow(r_new[i] - r[i], 2));
+        }
+    }
+
+    return sum;
+}
+
+std::vector<float>
+graph::par_page_rank_checkpointed(const std::vector<float> &v, float beta, unsigned int max_iterations,
+                                  double tolerance, const std::string &checkpoint_file,
+                                  unsigned int checkpoint_interval, int n_thread, bool *resumed) const {
+    std::vector<float> r(v), r_new(v);
+    unsigned int iterations = 0;
+    float sum = 0;
+
+    // If n_thread is -1, use all available threads
+    if (n_thread == -1) {
+        n_thread = omp_get_max_threads();
+    }
+
+    checkpoint::state state;
+    state.fingerprint = get_fingerprint();
+    state.beta = beta;
+    state.tolerance = tolerance;
+
+    // resume from an unfinished checkpoint of the same problem; a finished one would only cost an extra iteration
+    // and override the starting vector
+    checkpoint::state saved;
+    bool resume = checkpoint::read(checkpoint_file, saved) && !saved.finished &&
+                  saved.fingerprint == state.fingerprint && saved.beta == beta && saved.tolerance == tolerance &&
+                  saved.r.size() == n;
+    if (resume) {
+        iterations = saved.iteration;
+        r_new = std::move(saved.r);
+        // std::cout << "Resuming from iteration " << iterations << std::endl;
+    }
+    if (resumed != nullptr)
+        *resumed = resume;
+
+    checkpoint::writer writer(checkpoint_file);
+
+    while (iterations < max_iterations) {
+        r = r_new;
+        sum = page_rank_sweep(r, r_new, beta, nullptr, n_thread);
+
+        bool converged = ++iterations >= max_iterations || std::sqrt(sum) <= tolerance;
+
+        // hand a copy to the writer thread, the iterations go on while it is written to disk; an interval of 0 only
+        // saves the final state
+        if (converged || (checkpoint_interval != 0 && iterations % checkpoint_interval == 0)) {
+            state.iteration = iterations;
+            state.residual = std::sqrt(sum);
+            state.finished = converged;
+            state.r = r_new;
+            writer.submit(state);
+        }
+
+        if (converged)
+            break;
+    }
+
+    if (!utility::check_distribution(r_new)) {
+        std::cerr << "The distribution is not correct! The vector sum up to "
+                  << std::accumulate(r_new.begin(), r_new.end(), 0.0) << std::endl;
+    }
+
+    return r_new;
+}
+
+std::vector<float>
+graph::par_page_rank_personalized(const std::vector<float> &v, const std::vector<float> &teleport, float beta,
+                                  unsigned int max_iterations, double tolerance, int n_thread) const {
+    std::vector<float> r(v), r_new(v);
+    unsigned int iterations = 0;
+    float sum;
+
+    // If n_thread is -1, use all available threads
+    if (n_thread == -1) {
+        n_thread = omp_get_max_threads();
+    }
+
+    do {
+        r = r_new;
+        sum = page_rank_sweep(r, r_new, beta, &teleport, n_thread);
+    } while (++iterations < max_iterations && std::sqrt(sum) > tolerance);
+
+    if (!utility::check_distribution(r_new)) {
+        std::cerr << "The distribution is not correct! The vector sum up to "
+                  << std::accumulate(r_new.begin(), r_new.end(), 0.0) << std::endl;
+    }
+
+    return r_new;
+}
+
+std::vector<float>
+graph::par_page_rank_dangling(const std::vector<float> &v, float beta, unsigned int max_iterations, double tolerance,
+                              int n_thread) const {
+    // If n_thread is -1, use all available threads
+    if (n_thread == -1) {
+        n_thread = omp_get_max_threads();
+    }
+
+    // reorder vertices: non-dangling ones get ids [0, k), dead ends [k, n)
+    std::vector<unsigned int> new_id(n), old_id(n);
+    unsigned int k = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+        if (col_ids[i] != nullptr)
+            new_id[i] = k++;
+    }
+    unsigned int d = k;
+    for (unsigned int i = 0; i < n; ++i) {
+        if (col_ids[i] == nullptr)
+            new_id[i] = d++;
+        old_id[new_id[i]] = i;
+    }
+
+    // row-wise (pull) representation of the reordered matrix; every source is non-dangling, so a row only reads the
+    // first k entries of the rank vector
+    std::vector<unsigned int> row_offsets(n + 1, 0), sources(m);
+    std::vector<float> inv_out_degree(k);
+    for (unsigned int i = 0; i < n; ++i) {
+        if (col_ids[i] != nullptr) {
+            inv_out_degree[new_id[i]] = 1 / static_cast<float>(col_ids[i]->size());
+            for (auto &j: *col_ids[i])
+                row_offsets[new_id[j] + 1]++;
+        }
+    }
+    std::partial_sum(row_offsets.begin(), row_offsets.end(), row_offsets.begin());
+    std::vector<unsigned int> next(row_offsets.begin(), row_offsets.end() - 1);
+    for (unsigned int i = 0; i < n; ++i) {
+        if (col_ids[i] != nullptr) {
+            for (auto &j: *col_ids[i])
+                sources[next[new_id[j]]++] = new_id[i];
+        }
+    }
+
+    // solve x1 (I - beta H11) = u1 with u uniform, iterating only on the non-dangling block
+    float u = 1 / static_cast<float>(n);
+    std::vector<float> x(n), x_new(n);
+    for (unsigned int i = 0; i < k; ++i)
+        x_new[i] = v[old_id[i]];
+
+    unsigned int iterations = 0;
+    float sum;
+
+    do {
+        std::swap(x, x_new);
+        sum = 0;
+
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+        firstprivate(beta, u, k) shared(x, x_new, row_offsets, sources, inv_out_degree) \
+        schedule(dynamic, 256) reduction(+:sum)
+        for (unsigned int i = 0; i < k; ++i) {
+            float x_i = 0;
+            for (unsigned int e = row_offsets[i]; e < row_offsets[i + 1]; ++e)
+                x_i += x[sources[e]] * inv_out_degree[sources[e]];
+
+            x_new[i] = beta * x_i + u;
+            sum += (x_new[i] - x[i]) * (x_new[i] - x[i]);
+        }
+    } while (++iterations < max_iterations && std::sqrt(sum) > tolerance);
+
+    // recover the dead ends with a single pass: x2 = beta x1 H12 + u2, then normalize and undo the reordering
+    double norm = 0;
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+        firstprivate(beta, u, k, n) shared(x_new, row_offsets, sources, inv_out_degree) \
+        schedule(dynamic, 256)
+    for (unsigned int i = k; i < n; ++i) {
+        float x_i = 0;
+        for (unsigned int e = row_offsets[i]; e < row_offsets[i + 1]; ++e)
+            x_i += x_new[sources[e]] * inv_out_degree[sources[e]];
+
+        x_new[i] = beta * x_i + u;
+    }
+
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+        shared(x_new, n) reduction(+:norm)
+    for (unsigned int i = 0; i < n; ++i)
+        norm += x_new[i];
+
+    std::vector<float> r_new(n);
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+        firstprivate(norm) shared(x_new, r_new, old_id, n)
+    for (unsigned int i = 0; i < n; ++i)
+        r_new[old_id[i]] = static_cast<float>(x_new[i] / norm);
+
+    if (!utility::check_distribution(r_new)) {
+        std::cerr << "The distribution is not correct! The vector sum up to "
+                  << std::accumulate(r_new.begin(), r_new.end(), 0.0) << std::endl;
+    }
+
+    return r_new;
+}
+
+void graph::get_in_edges(std::vector<unsigned int> &offsets, std::vector<unsigned int> &sources) const {
+    offsets.assign(n + 1, 0);
+    sources.resize(m);
+    for (unsigned int i = 0; i < n; ++i) {
+        if (col_ids[i] != nullptr) {
+            for (auto &j: *col_ids[i])
+                offsets[j + 1]++;
+        }
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<unsigned int> next(offsets.begin(), offsets.end() - 1);
+    for (unsigned int i = 0; i < n; ++i) {
+        if (col_ids[i] != nullptr) {
+            for (auto &j: *col_ids[i])
+                sources[next[j]++] = i;
+        }
+    }
+}
+
+std::vector<unsigned int> graph::get_scc(unsigned int &num_components, int n_thread) const {
+    // maximum number of trimming rounds, whatever is left afterward is handled by Tarjan
+    const unsigned int max_trim_rounds = 8;
+    const unsigned int unassigned = static_cast<unsigned int>(-1);
+
+    // If n_thread is -1, use all available threads
+    if (n_thread == -1) {
+        n_thread = omp_get_max_threads();
+    }
+
+    std::vector<unsigned int> in_offsets, in_sources;
+    get_in_edges(in_offsets, in_sources);
+
+    std::vector<unsigned int> comp(n, unassigned);
+    std::vector<unsigned char> alive(n, 1), trimmed(n, 0);
+    num_components = 0;
+
+    // trimming: a node without live in-edges or out-edges is a component on its own
+    unsigned int round = 0, n_trimmed;
+    do {
+        n_trimmed = 0;
+
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+        shared(alive, trimmed, col_ids, in_offsets, in_sources, n) schedule(dynamic, 1024) \
+        reduction(+:n_trimmed)
+        for (unsigned int i = 0; i < n; ++i) {
+            if (!alive[i])
+                continue;
+
+            bool has_out = false, has_in = false;
+            if (col_ids[i] != nullptr) {
+                for (auto &j: *col_ids[i]) {
+                    if (alive[j]) {
+                        has_out = true;
+                        break;
+                    }
+                }
+            }
+            for (unsigned int e = in_offsets[i]; has_out && e < in_offsets[i + 1]; ++e) {
+                if (alive[in_sources[e]]) {
+                    has_in = true;
+                    break;
+                }
+            }
+
+            trimmed[i] = !(has_out && has_in);
+            n_trimmed += trimmed[i];
+        }
+
+        for (unsigned int i = 0; i < n; ++i) {
+            if (trimmed[i]) {
+                alive[i] = 0;
+                trimmed[i] = 0;
+                comp[i] = num_components++;
+            }
+        }
+    } while (n_trimmed > 0 && ++round < max_trim_rounds);
+
+    // Forward-Backward from the live node with the largest degree product, which almost surely lies in the giant SCC
+    unsigned int pivot = unassigned;
+    size_t best = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+        if (alive[i]) {
+            size_t degree = static_cast<size_t>(col_ids[i]->size()) * (in_offsets[i + 1] - in_offsets[i]);
+            if (pivot == unassigned || degree > best) {
+                pivot = i;
+                best = degree;
+            }
+        }
+    }
+
+    if (pivot != unassigned) {
+        std::vector<unsigned char> forward(n, 0), backward(n, 0);
+        std::vector<unsigned int> **out_ids = col_ids;
+
+        // level-synchronous parallel BFS restricted to live nodes
+        auto bfs = [&](std::vector<unsigned char> &visited, bool use_out_edges) {
+            std::vector<unsigned int> frontier{pivot};
+            visited[pivot] = 1;
+
+            while (!frontier.empty()) {
+                std::vector<unsigned int> next_frontier;
+
+#pragma omp parallel if(n_thread != 1) num_threads(n_thread) default(none) \
+        shared(frontier, next_frontier, visited, alive, out_ids, in_offsets, in_sources, use_out_edges)
+                {
+                    std::vector<unsigned int> local;
+
+                    auto visit = [&](unsigned int j) {
+                        if (!alive[j])
+                            return;
+
+                        // cheap pre-check, the capture below decides which thread claims j
+                        unsigned char old;
+#pragma omp atomic read
+                        old = visited[j];
+                        if (old)
+                            return;
+
+#pragma omp atomic capture
+                        {
+                            old = visited[j];
+                            visited[j] = 1;
+                        }
+                        if (!old)
+                            local.push_back(j);
+                    };
+
+#pragma omp for schedule(dynamic, 64) nowait
+                    for (unsigned int k = 0; k < frontier.size(); ++k) {
+                        unsigned int i = frontier[k];
+                        if (use_out_edges) {
+                            for (auto &j: *out_ids[i])
+                                visit(j);
+                        } else {
+                            for (unsigned int e = in_offsets[i]; e < in_offsets[i + 1]; ++e)
+                                visit(in_sources[e]);
+                        }
+                    }
+
+#pragma omp critical
+                    next_frontier.insert(next_frontier.end(), local.begin(), local.end());
+                }
+
+                frontier.swap(next_frontier);
+            }
+        };
+
+        bfs(forward, true);
+        bfs(backward, false);
+
+        unsigned int giant = num_components++;
+        for (unsigned int i = 0; i < n; ++i) {
+            if (forward[i] && backward[i]) {
+                comp[i] = giant;
+                alive[i] = 0;
+            }
+        }
+    }
+
+    // iterative Tarjan on the nodes that are still live; SCCs never cross the trimmed nodes or the giant component
+    std::vector<unsigned int> index(n, unassigned), low_link(n), stack, call_stack, edge_pos(n);
+    std::vector<unsigned char> on_stack(n, 0);
+    unsigned int next_index = 0;
+
+    for (unsigned int root = 0; root < n; ++root) {
+        if (!alive[root] || index[root] != unassigned)
+            continue;
+
+        call_stack.push_back(root);
+        index[root] = low_link[root] = next_index++;
+        edge_pos[root] = 0;
+        stack.push_back(root);
+        on_stack[root] = 1;
+
+        while (!call_stack.empty()) {
+            unsigned int i = call_stack.back();
+
+            if (edge_pos[i] < col_ids[i]->size()) {
+                unsigned int j = (*col_ids[i])[edge_pos[i]++];
+                if (!alive[j])
+                    continue;
+
+                if (index[j] == unassigned) {
+                    index[j] = low_link[j] = next_index++;
+                    edge_pos[j] = 0;
+                    stack.push_back(j);
+                    on_stack[j] = 1;
+                    call_stack.push_back(j);
+                } else if (on_stack[j]) {
+                    low_link[i] = std::min(low_link[i], index[j]);
+                }
+                continue;
+            }
+
+            call_stack.pop_back();
+            if (!call_stack.empty()) {
+                unsigned int parent = call_stack.back();
+                low_link[parent] = std::min(low_link[parent], low_link[i]);
+            }
+
+            if (low_link[i] == index[i]) {
+                unsigned int j;
+                do {
+                    j = stack.back();
+                    stack.pop_back();
+                    on_stack[j] = 0;
+                    comp[j] = num_components;
+                } while (j != i);
+                num_components++;
+            }
+        }
+    }
+
+    return comp;
+}
+
+std::vector<float>
+graph::par_page_rank_scc(const std::vector<float> &v, float beta, unsigned int max_iterations, double tolerance,
+                         int n_thread, unsigned int small_scc_size) const {
+    // If n_thread is -1, use all available threads
+    if (n_thread == -1) {
+        n_thread = omp_get_max_threads();
+    }
+
+    unsigned int num_components;
+    std::vector<unsigned int> comp = get_scc(num_components, n_thread);
+
+    std::vector<unsigned int> in_offsets, in_sources;
+    get_in_edges(in_offsets, in_sources);
+
+    std::vector<float> inv_out_degree(n, 0);
+    for (unsigned int i = 0; i < n; ++i) {
+        if (col_ids[i] != nullptr)
+            inv_out_degree[i] = 1 / static_cast<float>(col_ids[i]->size());
+    }
+
+    // nodes grouped by component
+    std::vector<unsigned int> comp_offsets(num_components + 1, 0), comp_nodes(n);
+    for (unsigned int i = 0; i < n; ++i)
+        comp_offsets[comp[i] + 1]++;
+    std::partial_sum(comp_offsets.begin(), comp_offsets.end(), comp_offsets.begin());
+    std::vector<unsigned int> next(comp_offsets.begin(), comp_offsets.end() - 1);
+    for (unsigned int i = 0; i < n; ++i)
+        comp_nodes[next[comp[i]]++] = i;
+
+    // topological levels of the condensation (Kahn): components on the same level do not depend on each other
+    std::vector<unsigned int> comp_in_degree(num_components, 0), level(num_components, 0);
+    for (unsigned int i = 0; i < n; ++i) {
+        if (col_ids[i] != nullptr) {
+            for (auto &j: *col_ids[i]) {
+                if (comp[i] != comp[j])
+                    comp_in_degree[comp[j]]++;
+            }
+        }
+    }
+
+    std::vector<unsigned int> order;
+    order.reserve(num_components);
+    for (unsigned int c = 0; c < num_components; ++c) {
+        if (comp_in_degree[c] == 0)
+            order.push_back(c);
+    }
+    unsigned int num_levels = 0;
+    for (unsigned int k = 0; k < order.size(); ++k) {
+        unsigned int c = order[k];
+        num_levels = std::max(num_levels, level[c] + 1);
+        for (unsigned int p = comp_offsets[c]; p < comp_offsets[c + 1]; ++p) {
+            unsigned int i = comp_nodes[p];
+            if (col_ids[i] == nullptr)
+                continue;
+
+            for (auto &j: *col_ids[i]) {
+                if (comp[j] != c) {
+                    level[comp[j]] = std::max(level[comp[j]], level[c] + 1);
+                    if (--comp_in_degree[comp[j]] == 0)
+                        order.push_back(comp[j]);
+                }
+            }
+        }
+    }
+
+    std::vector<std::vector<unsigned int>> small_by_level(num_levels), large_by_level(num_levels);
+    for (unsigned int c = 0; c < num_components; ++c) {
+        if (comp_offsets[c + 1] - comp_offsets[c] <= small_scc_size)
+            small_by_level[level[c]].push_back(c);
+        else
+            large_by_level[level[c]].push_back(c);
+    }
+
+    // solve x (I - beta H) = u with u uniform (dead ends are handled as in par_page_rank_dangling); H is block
+    // triangular in topological order, so every component only needs the already solved predecessors
+    float u = 1 / static_cast<float>(n);
+    std::vector<float> x(n, 0);
+
+    // teleportation plus the contribution of the predecessor components
+    auto external_rank = [&](unsigned int j) {
+        float x_j = 0;
+        for (unsigned int e = in_offsets[j]; e < in_offsets[j + 1]; ++e) {
+            unsigned int i = in_sources[e];
+            if (comp[i] != comp[j])
+                x_j += x[i] * inv_out_degree[i];
+        }
+        return beta * x_j + u;
+    };
+
+    // local index of each node inside its component, to read the iterate of the component
+    std::vector<unsigned int> local_id(n);
+    for (unsigned int c = 0; c < num_components; ++c) {
+        for (unsigned int p = comp_offsets[c]; p < comp_offsets[c + 1]; ++p)
+            local_id[comp_nodes[p]] = p - comp_offsets[c];
+    }
+
+    // Jacobi iteration on a single component, with n_inner threads
+    auto solve_large = [&](unsigned int c, int n_inner) {
+        unsigned int first = comp_offsets[c], size = comp_offsets[c + 1] - first;
+        std::vector<float> base(size), x_c(size), x_c_new(size);
+
+#pragma omp parallel for if(n_inner != 1) num_threads(n_inner) default(none) \
+        shared(base, x_c_new, comp_nodes, first, size, external_rank, v)
+        for (unsigned int p = 0; p < size; ++p) {
+            base[p] = external_rank(comp_nodes[first + p]);
+            x_c_new[p] = v[comp_nodes[first + p]];
+        }
+
+        unsigned int iterations = 0;
+        float sum;
+        do {
+            std::swap(x_c, x_c_new);
+            sum = 0;
+
+#pragma omp parallel for if(n_inner != 1) num_threads(n_inner) default(none) \
+        shared(base, x_c, x_c_new, comp_nodes, local_id, comp, in_offsets, in_sources, inv_out_degree, first, size, \
+               c, beta) schedule(dynamic, 256) reduction(+:sum)
+            for (unsigned int p = 0; p < size; ++p) {
+                unsigned int j = comp_nodes[first + p];
+                float x_j = 0;
+                for (unsigned int e = in_offsets[j]; e < in_offsets[j + 1]; ++e) {
+                    unsigned int i = in_sources[e];
+                    if (comp[i] == c)
+                        x_j += x_c[local_id[i]] * inv_out_degree[i];
+                }
+
+                x_c_new[p] = beta * x_j + base[p];
+                sum += (x_c_new[p] - x_c[p]) * (x_c_new[p] - x_c[p]);
+            }
+        } while (++iterations < max_iterations && std::sqrt(sum) > tolerance);
+
+        for (unsigned int p = 0; p < size; ++p)
+            x[comp_nodes[first + p]] = x_c_new[p];
+    };
+
+    for (unsigned int l = 0; l < num_levels; ++l) {
+        // small components: exact solve, many of them concurrently
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+        shared(small_by_level, l, comp_offsets, comp_nodes, comp, in_offsets, in_sources, inv_out_degree, x, \
+               external_rank, beta) schedule(dynamic, 16)
+        for (unsigned int k = 0; k < small_by_level[l].size(); ++k) {
+            unsigned int c = small_by_level[l][k];
+            unsigned int first = comp_offsets[c], size = comp_offsets[c + 1] - first;
+
+            if (size == 1) {
+                unsigned int j = comp_nodes[first];
+                float self_weight = 0;
+                for (unsigned int e = in_offsets[j]; e < in_offsets[j + 1]; ++e) {
+                    if (in_sources[e] == j)
+                        self_weight += inv_out_degree[j];
+                }
+                x[j] = external_rank(j) / (1 - beta * self_weight);
+                continue;
+            }
+
+            // dense (I - beta A) x = b by Gaussian elimination with partial pivoting, A[p][q] = weight of q -> p
+            std::vector<double> a(size * (size + 1), 0);
+            auto at = [&a, size](unsigned int p, unsigned int q) -> double & { return a[p * (size + 1) + q]; };
+            for (unsigned int p = 0; p < size; ++p) {
+                unsigned int j = comp_nodes[first + p];
+                at(p, p) = 1;
+                at(p, size) = external_rank(j);
+                for (unsigned int e = in_offsets[j]; e < in_offsets[j + 1]; ++e) {
+                    unsigned int i = in_sources[e];
+                    if (comp[i] == c) {
+                        unsigned int q = std::lower_bound(comp_nodes.begin() + first,
+                                                          comp_nodes.begin() + first + size, i) -
+                                         (comp_nodes.begin() + first);
+                        at(p, q) -= beta * inv_out_degree[i];
+                    }
+                }
+            }
+
+            for (unsigned int q = 0; q < size; ++q) {
+                unsigned int pivot = q;
+                for (unsigned int p = q + 1; p < size; ++p) {
+                    if (std::abs(at(p, q)) > std::abs(at(pivot, q)))
+                        pivot = p;
+                }
+                for (unsigned int t = q; t <= size; ++t)
+                    std::swap(at(q, t), at(pivot, t));
+
+                for (unsigned int p = q + 1; p < size; ++p) {
+                    double factor = at(p, q) / at(q, q);
+                    for (unsigned int t = q; t <= size; ++t)
+                        at(p, t) -= factor * at(q, t);
+                }
+            }
+
+            // back-substitution in double, narrowed to float only when stored
+            std::vector<double> solution(size);
+            for (unsigned int q = size; q-- > 0;) {
+                double x_q = at(q, size);
+                for (unsigned int t = q + 1; t < size; ++t)
+                    x_q -= at(q, t) * solution[t];
+                solution[q] = x_q / at(q, q);
+                x[comp_nodes[first + q]] = static_cast<float>(solution[q]);
+            }
+        }
+
+        // large components: iterate. A single one big enough to amortize the synchronization (typically the giant SCC)
+        // is parallel inside, several ones on the same level are solved concurrently, one per thread
+        auto &large = large_by_level[l];
+        int inner_threads = large.size() == 1 && comp_offsets[large[0] + 1] - comp_offsets[large[0]] >= 16384
+                            ? n_thread : 1;
+
+#pragma omp parallel for if(n_thread != 1 && large.size() > 1) num_threads(n_thread) default(none) \
+        shared(large, inner_threads, solve_large) schedule(dynamic, 1)
+        for (unsigned int k = 0; k < large.size(); ++k)
+            solve_large(large[k], inner_threads);
+    }
+
+    double norm = 0;
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) shared(x, n) reduction(+:norm)
+    for (unsigned int i = 0; i < n; ++i)
+        norm += x[i];
+
+    std::vector<float> r_new(n);
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) firstprivate(norm) shared(x, r_new, n)
+    for (unsigned int i = 0; i < n; ++i)
+        r_new[i] = static_cast<float>(x[i] / norm);
+
+    if (!utility::check_distribution(r_new)) {
+        std::cerr << "The distribution is not correct! The vector sum up to "
+                  << std::accumulate(r_new.begin(), r_new.end(), 0.0) << std::endl;
+    }
+
+    return r_new;
+}
+
+// xorshift64* generator, one state per thread
+static inline unsigned long long next_random(unsigned long long &state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+// uniform integer in [0, bound) by multiply-shift
+static inline unsigned int random_below(unsigned long long &state, size_t bound) {
+    return static_cast<unsigned int>(((next_random(state) >> 32) * bound) >> 32);
+}
+
+std::vector<float>
+graph::par_page_rank_monte_carlo(float beta, unsigned int max_rounds, unsigned int top_k, unsigned int stable_rounds,
+                                 int n_thread, unsigned long long seed) const {
+    // If n_thread is -1, use all available threads
+    if (n_thread == -1) {
+        n_thread = omp_get_max_threads();
+    }
+
+    // the walk goes on while the top 53 bits of a random number, as a fraction, are below beta
+    const unsigned long long continue_threshold = static_cast<unsigned long long>(
+            static_cast<double>(beta) * static_cast<double>(1ULL << 53));
+
+    std::vector<std::vector<unsigned int>> thread_visits(n_thread, std::vector<unsigned int>(n, 0));
+    std::vector<unsigned long long> visits(n, 0);
+    std::vector<unsigned long long> rng(n_thread);
+    for (int t = 0; t < n_thread; ++t) {
+        // splitmix64 to decorrelate the per-thread seeds
+        unsigned long long z = seed + (t + 1) * 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        rng[t] = (z ^ (z >> 31)) | 1;
+    }
+
+    std::vector<unsigned int> ids(n), top, last_top;
+    unsigned int round = 0, unchanged = 0;
+
+    do {
+#pragma omp parallel if(n_thread != 1) num_threads(n_thread) default(none) \
+        shared(thread_visits, rng, col_ids, n, continue_threshold)
+        {
+            int t = omp_get_thread_num();
+            std::vector<unsigned int> &local_visits = thread_visits[t];
+            unsigned long long state = rng[t];
+
+#pragma omp for schedule(dynamic, 1024)
+            for (unsigned int start = 0; start < n; ++start) {
+                unsigned int i = start;
+                local_visits[i]++;
+
+                while ((next_random(state) >> 11) < continue_threshold) {
+                    if (col_ids[i] == nullptr)
+                        i = random_below(state, n);
+                    else
+                        i = (*col_ids[i])[random_below(state, col_ids[i]->size())];
+                    local_visits[i]++;
+                }
+            }
+
+            rng[t] = state;
+        }
+
+        // merge the per-thread counters
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+        shared(thread_visits, visits, n, n_thread)
+        for (unsigned int i = 0; i < n; ++i) {
+            for (int t = 0; t < n_thread; ++t) {
+                visits[i] += thread_visits[t][i];
+                thread_visits[t][i] = 0;
+            }
+        }
+
+        if (top_k > 0) {
+            unsigned int k = std::min<size_t>(top_k, n);
+            std::iota(ids.begin(), ids.end(), 0);
+            std::nth_element(ids.begin(), ids.begin() + k - 1, ids.end(), [&visits](unsigned int a, unsigned int b) {
+                return visits[a] > visits[b] || (visits[a] == visits[b] && a < b);
+            });
+            top.assign(ids.begin(), ids.begin() + k);
+            std::sort(top.begin(), top.end());
+
+            // the set is considered stable when at most 1% of it changed since the previous round
+            std::vector<unsigned int> common;
+            std::set_intersection(top.begin(), top.end(), last_top.begin(), last_top.end(),
+                                  std::back_inserter(common));
+            unchanged = 100 * (k - common.size()) <= k ? unchanged + 1 : 0;
+            last_top.swap(top);
+        }
+    } while (++round < max_rounds && (top_k == 0 || unchanged < stable_rounds));
+
+    // std::cout << "Rounds: " << round << std::endl;
+
+    double total = std::accumulate(visits.begin(), visits.end(), 0.0);
+    std::vector<float> r_new(n);
+    for (unsigned int i = 0; i < n; ++i)
+        r_new[i] = static_cast<float>(visits[i] / total);
+
+    return r_new;
+}
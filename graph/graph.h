@@ -1,6 +1,10 @@
 #ifndef ASSIGNMENT_1_LMD_GRAPH_H
 #define ASSIGNMENT_1_LMD_GRAPH_H
 
+#include <vector>
+#include <string>
+#include <cstdint>
+
 // for each column of M, store non-zero elements by using
 // an array of node ids, and a single value for o(j)
 class graph {
@@ -11,6 +15,14 @@ private:
     // sparse graph representation for adjacency graph
     std::vector<unsigned int> **col_ids; // array of node ids
 
+    // row-wise view of the adjacency: sources of the in-edges of node i are sources[offsets[i]..offsets[i + 1])
+    void get_in_edges(std::vector<unsigned int> &offsets, std::vector<unsigned int> &sources) const;
+
+    // one parallel iteration: scatters r into r_new along the out-edges, then adds teleportation and the dead ends,
+    // both following teleport (uniformly if it is null); returns the squared distance between r_new and r
+    float page_rank_sweep(const std::vector<float> &r, std::vector<float> &r_new, float beta,
+                          const std::vector<float> *teleport, int n_thread) const;
+
 public:
     graph(const unsigned int &n, const std::vector<std::pair<unsigned int, unsigned int>> &edges);
 
@@ -22,7 +34,7 @@ public:
     // return the number of nodes
     unsigned int get_n() const;
 
-    unsigned int get_m() const;
+    size_t get_m() const;
 
     double get_density() const;
 
@@ -30,12 +42,57 @@ public:
 
     void print(unsigned int max_n) const;
 
+    // hash of n and of the set of edges, independent of the edge order
+    uint64_t get_fingerprint() const;
+
+    // same value computed from the edge list, without building the graph
+    static uint64_t
+    get_fingerprint(const unsigned int &n, const std::vector<std::pair<unsigned int, unsigned int>> &edges);
+
     std::vector<float>
     seq_page_rank(const std::vector<float> &v, float beta, unsigned int max_iterations, double tolerance) const;
 
+    // chunk_size is the dynamic schedule chunk of the main loop, -1 for the default one
     std::vector<float>
     par_page_rank(const std::vector<float> &v, float beta, unsigned int max_iterations, double tolerance,
-                  int n_thread = -1) const;
+                  int n_thread = -1, int chunk_size = -1) const;
+
+    // same as par_page_rank, the state is saved to checkpoint_file every checkpoint_interval iterations (0: only the
+    // final state) by a background thread; if checkpoint_file holds an unfinished state for this graph, beta and
+    // tolerance the solve resumes from it instead of v. If resumed is not null, it tells whether that happened
+    std::vector<float>
+    par_page_rank_checkpointed(const std::vector<float> &v, float beta, unsigned int max_iterations, double tolerance,
+                               const std::string &checkpoint_file, unsigned int checkpoint_interval = 10,
+                               int n_thread = -1, bool *resumed = nullptr) const;
+
+    // personalized PageRank: teleportation and dead ends jump according to the teleport distribution instead of
+    // uniformly
+    std::vector<float>
+    par_page_rank_personalized(const std::vector<float> &v, const std::vector<float> &teleport, float beta,
+                               unsigned int max_iterations, double tolerance, int n_thread = -1) const;
+
+    // Langville-Meyer dangling node elimination: vertices are reordered so that dead ends come last, the iterative
+    // solve runs only on the non-dangling block and the dead-end ranks are recovered with a single final pass
+    std::vector<float>
+    par_page_rank_dangling(const std::vector<float> &v, float beta, unsigned int max_iterations, double tolerance,
+                           int n_thread = -1) const;
+
+    // strongly connected components (trimming + Forward-Backward for the giant component, Tarjan for the rest);
+    // returns the component id of each node
+    std::vector<unsigned int> get_scc(unsigned int &num_components, int n_thread = -1) const;
+
+    // BlockRank over the SCC condensation: components are solved in topological order, singletons and components up
+    // to small_scc_size nodes exactly, larger ones iteratively; components on the same DAG level run concurrently
+    std::vector<float>
+    par_page_rank_scc(const std::vector<float> &v, float beta, unsigned int max_iterations, double tolerance,
+                      int n_thread = -1, unsigned int small_scc_size = 64) const;
+
+    // Monte Carlo approximation: every round starts one random walk per node, walks stop with probability 1 - beta
+    // and every visit is counted; dead ends jump to a random node. With top_k > 0 the walks stop early once at most 1%
+    // of the top_k set has changed for stable_rounds consecutive rounds
+    std::vector<float>
+    par_page_rank_monte_carlo(float beta, unsigned int max_rounds, unsigned int top_k = 0,
+                              unsigned int stable_rounds = 3, int n_thread = -1, unsigned long long seed = 42) const;
 };
 
 
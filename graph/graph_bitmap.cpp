@@ -0,0 +1,173 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <bit>
+#include <array>
+#include <omp.h>
+#include "graph_bitmap.h"
+#include "../utility.h"
+
+// byte_masks[x][b] is 1 if bit b of x is set, 0 otherwise
+static const std::array<std::array<float, 8>, 256> byte_masks = [] {
+    std::array<std::array<float, 8>, 256> masks{};
+    for (unsigned int x = 0; x < 256; ++x) {
+        for (unsigned int b = 0; b < 8; ++b)
+            masks[x][b] = static_cast<float>((x >> b) & 1);
+    }
+    return masks;
+}();
+
+graph_bitmap::graph_bitmap(const unsigned int &n, const std::vector<std::pair<unsigned int, unsigned int>> &edges)
+        : n(n), m(edges.size()), words_per_row((n + 63) / 64) {
+    bits = std::vector<uint64_t>(n * words_per_row, 0);
+    out_degree = std::vector<unsigned int>(n, 0);
+    duplicate_offsets = std::vector<unsigned int>(n + 1, 0);
+
+    std::vector<std::pair<unsigned int, unsigned int>> duplicates;
+    for (auto &edge: edges) {
+        uint64_t &word = bits[edge.second * words_per_row + edge.first / 64];
+        uint64_t mask = uint64_t(1) << (edge.first % 64);
+        out_degree[edge.first]++;
+        if (word & mask) {
+            duplicates.push_back(edge);
+            duplicate_offsets[edge.second + 1]++;
+        } else {
+            word |= mask;
+        }
+    }
+
+    std::partial_sum(duplicate_offsets.begin(), duplicate_offsets.end(), duplicate_offsets.begin());
+    duplicate_sources = std::vector<unsigned int>(duplicates.size());
+    std::vector<unsigned int> next(duplicate_offsets.begin(), duplicate_offsets.end() - 1);
+    for (auto &edge: duplicates)
+        duplicate_sources[next[edge.second]++] = edge.first;
+}
+
+bool graph_bitmap::is_dense(const unsigned int &n, size_t m) {
+    return n > 1 && static_cast<double>(m) / (static_cast<double>(n) * (n - 1)) > density_threshold;
+}
+
+unsigned int graph_bitmap::get_n() const {
+    return n;
+}
+
+size_t graph_bitmap::get_m() const {
+    return m;
+}
+
+double graph_bitmap::get_density() const {
+    return static_cast<double>(m) / (n * (n - 1));
+}
+
+unsigned int graph_bitmap::get_num_dead_ends() const {
+    return std::count(out_degree.begin(), out_degree.end(), 0);
+}
+
+std::vector<float>
+graph_bitmap::seq_page_rank(const std::vector<float> &v, float beta, unsigned int max_iterations,
+                            double tolerance) const {
+    return par_page_rank(v, beta, max_iterations, tolerance, 1);
+}
+
+std::vector<float>
+graph_bitmap::par_page_rank(const std::vector<float> &v, float beta, unsigned int max_iterations, double tolerance,
+                            int n_thread) const {
+    std::vector<float> r(v), r_new(v);
+    unsigned int iterations = 0;
+    float sum, teleportation_correction = (1 - beta) / static_cast<float>(n);
+
+    // If n_thread is -1, use all available threads
+    if (n_thread == -1) {
+        n_thread = omp_get_max_threads();
+    }
+
+    // r[j] / o(j) padded with zeros up to a whole number of words, and its sum over each 64-node block
+    std::vector<float> weights(words_per_row * 64, 0), block_sums(words_per_row);
+
+    do {
+        r = r_new;
+        float r_sum_dead_ends = 0;
+
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+        shared(r, weights, out_degree, n) reduction(+:r_sum_dead_ends)
+        for (unsigned int j = 0; j < n; ++j) {
+            if (out_degree[j] == 0) {
+                r_sum_dead_ends += r[j];
+                weights[j] = 0;
+            } else {
+                weights[j] = r[j] / static_cast<float>(out_degree[j]);
+            }
+        }
+
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+        shared(weights, block_sums, words_per_row)
+        for (size_t w = 0; w < words_per_row; ++w) {
+            float block_sum = 0;
+#pragma omp simd reduction(+:block_sum)
+            for (unsigned int b = 0; b < 64; ++b)
+                block_sum += weights[w * 64 + b];
+            block_sums[w] = block_sum;
+        }
+
+        float dead_end_weight = r_sum_dead_ends / static_cast<float>(n);
+        sum = 0;
+
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+        firstprivate(beta, dead_end_weight, teleportation_correction) \
+        shared(r, r_new, bits, weights, block_sums, byte_masks, words_per_row, duplicate_offsets, duplicate_sources, n) \
+        schedule(static) reduction(+:sum)
+        for (unsigned int i = 0; i < n; ++i) {
+            const uint64_t *row = &bits[i * words_per_row];
+            float r_i = 0;
+
+            for (size_t w = 0; w < words_per_row; ++w) {
+                uint64_t word = row[w];
+                int count = std::popcount(word);
+                const float *block = &weights[w * 64];
+
+                if (count == 0)
+                    continue;
+
+                if (count == 64) {
+                    // all the 64 sources link to i
+                    r_i += block_sums[w];
+                } else if (count <= 4) {
+                    // few sources: visit the set bits only
+                    while (word) {
+                        r_i += block[std::countr_zero(word)];
+                        word &= word - 1;
+                    }
+                } else {
+                    // masked sum over the whole word, one byte of the mask expanded to 8 floats at a time
+                    float word_sum = 0;
+                    for (unsigned int byte = 0; byte < 8; ++byte) {
+                        const float *mask = byte_masks[(word >> (8 * byte)) & 0xFF].data();
+#pragma omp simd reduction(+:word_sum)
+                        for (unsigned int b = 0; b < 8; ++b)
+                            word_sum += mask[b] * block[8 * byte + b];
+                    }
+                    r_i += word_sum;
+                }
+            }
+
+            // further copies of the edges
+            for (unsigned int e = duplicate_offsets[i]; e < duplicate_offsets[i + 1]; ++e)
+                r_i += weights[duplicate_sources[e]];
+
+            // apply teleportation and add all dead ends to each node
+            r_new[i] = (r_i + dead_end_weight) * beta + teleportation_correction;
+            sum += (r_new[i] - r[i]) * (r_new[i] - r[i]);
+        }
+    } while (++iterations < max_iterations && std::sqrt(sum) > tolerance);
+
+    // std::cout << "Iterations: " << iterations << std::endl;
+
+    if (!utility::check_distribution(r_new)) {
+        std::cerr << "The distribution is not correct! The vector sum up to "
+                  << std::accumulate(r_new.begin(), r_new.end(), 0.0) << std::endl;
+    }
+
+    return r_new;
+}
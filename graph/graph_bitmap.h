@@ -0,0 +1,49 @@
+#ifndef ASSIGNMENT_1_LMD_GRAPH_BITMAP_H
+#define ASSIGNMENT_1_LMD_GRAPH_BITMAP_H
+
+#include <vector>
+#include <cstdint>
+
+// dense graphs: bit matrix with one row per node, bit j of row i set if there is an edge j -> i, so that PageRank is
+// a masked dense matrix-vector product over 64-bit words
+class graph_bitmap {
+private:
+    size_t n; // number of nodes
+    size_t m; // number of edges, duplicates included like in the other representations
+    size_t words_per_row;
+
+    std::vector<uint64_t> bits;
+    std::vector<unsigned int> out_degree; // counts every duplicate
+
+    // a bit holds a single edge: every further copy of j -> i is kept in duplicate_sources[duplicate_offsets[i]..]
+    std::vector<unsigned int> duplicate_offsets;
+    std::vector<unsigned int> duplicate_sources;
+
+public:
+    // above this density the bit matrix takes less memory than 32-bit neighbour lists (1 bit per pair vs 32 per edge)
+    static constexpr double density_threshold = 1. / 32;
+
+    // whether a graph with n nodes and m edges is above density_threshold, so that it can be decided before building
+    // any representation
+    static bool is_dense(const unsigned int &n, size_t m);
+
+    graph_bitmap(const unsigned int &n, const std::vector<std::pair<unsigned int, unsigned int>> &edges);
+
+    // return the number of nodes
+    unsigned int get_n() const;
+
+    size_t get_m() const;
+
+    double get_density() const;
+
+    unsigned int get_num_dead_ends() const;
+
+    std::vector<float>
+    seq_page_rank(const std::vector<float> &v, float beta, unsigned int max_iterations, double tolerance) const;
+
+    std::vector<float>
+    par_page_rank(const std::vector<float> &v, float beta, unsigned int max_iterations, double tolerance,
+                  int n_thread = -1) const;
+};
+
+#endif //ASSIGNMENT_1_LMD_GRAPH_BITMAP_H
@@ -108,7 +108,7 @@ std::vector<float> graph_by_row::seq_page_rank(const std::vector<float> &v, floa
 
 std::vector<float>
 graph_by_row::par_page_rank(const std::vector<float> &v, float beta, unsigned int max_iterations, double tolerance,
-                            int n_thread) const {
+                            int n_thread, int chunk_size) const {
     std::vector<float> r(v), r_new(v);
     unsigned int iterations = 0;
     float sum, teleportation_correction = (1 - beta) / static_cast<float>(n);
@@ -118,6 +118,11 @@ graph_by_row::par_page_rank(const std::vector<float> &v, float beta, unsigned in
         n_thread = omp_get_max_threads();
     }
 
+    // If chunk_size is -1, use n_thread rows
+    if (chunk_size == -1) {
+        chunk_size = n_thread;
+    }
+
 #pragma omp ordered
     do {
         r = r_new;
@@ -125,8 +130,8 @@ graph_by_row::par_page_rank(const std::vector<float> &v, float beta, unsigned in
         sum = 0;
 
 #pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
-    firstprivate(teleportation_correction, beta, n, m, n_thread) shared(r, r_new, count_col_elements, row_ids, dead_ends_ids) \
-    schedule(dynamic, n_thread) \
+    firstprivate(teleportation_correction, beta, n, chunk_size) shared(r, r_new, count_col_elements, row_ids, dead_ends_ids) \
+    schedule(dynamic, chunk_size) \
     reduction(+:sum)
         for (unsigned int i = 0; i < n; ++i) {
             if (row_ids[i] != nullptr) {
@@ -157,3 +162,95 @@ graph_by_row::par_page_rank(const std::vector<float> &v, float beta, unsigned in
 
     return r_new;
 }
+
+std::vector<float>
+graph_by_row::par_page_rank_adaptive(const std::vector<float> &v, float beta, unsigned int max_iterations,
+                                     double tolerance, double vertex_tolerance, int n_thread) const {
+    // number of consecutive sweeps under vertex_tolerance before a vertex is frozen
+    const unsigned char freeze_after = 2;
+
+    std::vector<float> r(v), r_new(v);
+    unsigned int iterations = 0;
+    float sum, teleportation_correction = (1 - beta) / static_cast<float>(n);
+    bool converged = false;
+
+    // If n_thread is -1, use all available threads
+    if (n_thread == -1) {
+        n_thread = omp_get_max_threads();
+    }
+
+    // if every vertex moves less than tolerance / sqrt(n) the global residual is below tolerance
+    if (vertex_tolerance < 0) {
+        vertex_tolerance = tolerance / std::sqrt(static_cast<double>(n));
+    }
+
+    // active rows, kept compacted so the pull loop only touches vertices that are still moving
+    std::vector<unsigned int> active(n);
+    std::iota(active.begin(), active.end(), 0);
+    std::vector<unsigned char> stable(n, 0);
+
+    do {
+        r = r_new; // frozen vertices keep their previous value in r_new
+        sum = 0;
+
+        // dead ends contribute the same amount to every vertex, compute it once per sweep
+        float r_sum_dead_ends = 0;
+        if (dead_ends_ids != nullptr) {
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+    shared(r, dead_ends_ids) reduction(+:r_sum_dead_ends)
+            for (unsigned int k = 0; k < dead_ends_ids->size(); ++k) {
+                r_sum_dead_ends += r[(*dead_ends_ids)[k]];
+            }
+        }
+        float dead_end_weight = r_sum_dead_ends / static_cast<float>(n);
+        bool full_sweep = active.size() == n;
+
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+    firstprivate(teleportation_correction, beta, dead_end_weight, vertex_tolerance, n_thread) \
+    shared(r, r_new, count_col_elements, row_ids, active, stable) \
+    schedule(dynamic, n_thread) \
+    reduction(+:sum)
+        for (unsigned int k = 0; k < active.size(); ++k) {
+            unsigned int i = active[k];
+            float r_i = 0;
+            if (row_ids[i] != nullptr) {
+                for (auto &j: *row_ids[i]) {
+                    r_i += r[j] / static_cast<float>(count_col_elements[j]);
+                }
+            }
+
+            // apply teleportation
+            r_new[i] = (r_i + dead_end_weight) * beta + teleportation_correction;
+            float diff = r_new[i] - r[i];
+            sum += diff * diff;
+
+            if (std::abs(diff) < vertex_tolerance) {
+                if (stable[i] < freeze_after)
+                    stable[i]++;
+            } else {
+                stable[i] = 0;
+            }
+        }
+
+        if (std::sqrt(sum) <= tolerance) {
+            if (full_sweep) {
+                converged = true;
+            } else {
+                // the residual of the active set is not the global one: verify with a sweep over all vertices
+                active.resize(n);
+                std::iota(active.begin(), active.end(), 0);
+            }
+        } else {
+            std::erase_if(active, [&stable, freeze_after](unsigned int i) { return stable[i] >= freeze_after; });
+        }
+    } while (++iterations < max_iterations && !converged);
+
+    // std::cout << "Iterations: " << iterations << std::endl;
+
+    if (!utility::check_distribution(r_new)) {
+        std::cerr << "The distribution is not correct! The vector sum up to "
+                  << std::accumulate(r_new.begin(), r_new.end(), 0.0) << std::endl;
+    }
+
+    return r_new;
+}
@@ -1,6 +1,8 @@
 #ifndef ASSIGNMENT_1_LMD_GRAPH_BY_ROW_H
 #define ASSIGNMENT_1_LMD_GRAPH_BY_ROW_H
 
+#include <vector>
+
 class graph_by_row {
 private:
     size_t n; // number of nodes
@@ -26,9 +28,17 @@ public:
     std::vector<float>
     seq_page_rank(const std::vector<float> &v, float beta, unsigned int max_iterations, double tolerance) const;
 
+    // chunk_size is the dynamic schedule chunk of the main loop, -1 for the default one
     std::vector<float>
     par_page_rank(const std::vector<float> &v, float beta, unsigned int max_iterations, double tolerance,
-                  int n_thread = -1) const;
+                  int n_thread = -1, int chunk_size = -1) const;
+
+    // adaptive variant: vertices whose rank changes less than vertex_tolerance for a few consecutive sweeps are
+    // frozen and dropped from the active list; convergence is only accepted after a sweep over all vertices.
+    // vertex_tolerance = -1 uses tolerance / sqrt(n)
+    std::vector<float>
+    par_page_rank_adaptive(const std::vector<float> &v, float beta, unsigned int max_iterations, double tolerance,
+                           double vertex_tolerance = -1, int n_thread = -1) const;
 };
 
 #endif //ASSIGNMENT_1_LMD_GRAPH_BY_ROW_H
@@ -0,0 +1,144 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <omp.h>
+#include "graph_csr.h"
+#include "../utility.h"
+
+template<typename Node, typename Offset, typename Rank>
+graph_csr<Node, Offset, Rank>::graph_csr(const unsigned int &n,
+                                         const std::vector<std::pair<unsigned int, unsigned int>> &edges)
+        : n(n), m(edges.size()) {
+    offsets = std::vector<Offset>(n + 1, 0);
+    sources = std::vector<Node>(m);
+    std::vector<Offset> out_degree(n, 0);
+
+    for (auto &edge: edges) {
+        offsets[edge.second + 1]++;
+        out_degree[edge.first]++;
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<Offset> next(offsets.begin(), offsets.end() - 1);
+    for (auto &edge: edges)
+        sources[next[edge.second]++] = edge.first;
+
+    inv_out_degree = std::vector<accumulator>(n, 0);
+    for (size_t j = 0; j < n; ++j) {
+        if (out_degree[j] == 0)
+            dead_ends.push_back(j);
+        else
+            inv_out_degree[j] = 1 / static_cast<accumulator>(out_degree[j]);
+    }
+}
+
+template<typename Node, typename Offset, typename Rank>
+size_t graph_csr<Node, Offset, Rank>::get_n() const {
+    return n;
+}
+
+template<typename Node, typename Offset, typename Rank>
+size_t graph_csr<Node, Offset, Rank>::get_m() const {
+    return m;
+}
+
+template<typename Node, typename Offset, typename Rank>
+std::vector<typename graph_csr<Node, Offset, Rank>::accumulator>
+graph_csr<Node, Offset, Rank>::par_page_rank(const std::vector<float> &v, float beta, unsigned int max_iterations,
+                                             double tolerance, int n_thread, unsigned int *iterations) const {
+    // If n_thread is -1, use all available threads
+    if (n_thread == -1) {
+        n_thread = omp_get_max_threads();
+    }
+
+    const accumulator scale = static_cast<accumulator>(std::min<double>(n, rank_max_scale<Rank>::value)), b = beta,
+            teleportation = (1 - b) * scale / static_cast<accumulator>(n);
+
+    // x = scale * r and the contribution w = x / o(j) of every source, both in the storage type
+    std::vector<Rank> x(n), x_new(n), w(n);
+    for (size_t i = 0; i < n; ++i)
+        x_new[i] = static_cast<Rank>(v[i] * scale);
+
+    unsigned int iteration = 0;
+    double sum;
+
+    do {
+        std::swap(x, x_new);
+        accumulator x_sum_dead_ends = 0;
+        sum = 0;
+
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) shared(x, w, inv_out_degree, n)
+        for (size_t j = 0; j < n; ++j)
+            w[j] = static_cast<Rank>(static_cast<accumulator>(x[j]) * inv_out_degree[j]);
+
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) shared(x, dead_ends) \
+        reduction(+:x_sum_dead_ends)
+        for (size_t k = 0; k < dead_ends.size(); ++k)
+            x_sum_dead_ends += static_cast<accumulator>(x[dead_ends[k]]);
+
+        accumulator dead_end_weight = x_sum_dead_ends / static_cast<accumulator>(n);
+
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+        firstprivate(b, teleportation, dead_end_weight, scale) shared(x, x_new, w, offsets, sources, n) \
+        schedule(dynamic, 1024) reduction(+:sum)
+        for (size_t i = 0; i < n; ++i) {
+            accumulator x_i = 0;
+            for (Offset e = offsets[i]; e < offsets[i + 1]; ++e)
+                x_i += static_cast<accumulator>(w[sources[e]]);
+
+            // apply teleportation and add all dead ends to each node
+            x_i = (x_i + dead_end_weight) * b + teleportation;
+            x_new[i] = static_cast<Rank>(x_i);
+
+            double diff = (static_cast<double>(x_new[i]) - static_cast<double>(x[i])) / scale;
+            sum += diff * diff;
+        }
+    } while (++iteration < max_iterations && std::sqrt(sum) > tolerance);
+
+    if (iterations != nullptr)
+        *iterations = iteration;
+
+    std::vector<accumulator> r_new(n);
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) shared(x_new, r_new, scale, n)
+    for (size_t i = 0; i < n; ++i)
+        r_new[i] = static_cast<accumulator>(x_new[i]) / scale;
+
+    if (!utility::check_distribution(r_new)) {
+        std::cerr << "The distribution is not correct! The vector sum up to "
+                  << std::accumulate(r_new.begin(), r_new.end(), 0.0) << std::endl;
+    }
+
+    return r_new;
+}
+
+template class graph_csr<uint32_t, uint32_t, double>;
+template class graph_csr<uint32_t, uint32_t, float>;
+template class graph_csr<uint32_t, uint32_t, bfloat16>;
+template class graph_csr<uint32_t, uint64_t, double>;
+template class graph_csr<uint32_t, uint64_t, float>;
+template class graph_csr<uint32_t, uint64_t, bfloat16>;
+#ifdef GRAPH_HAS_FLOAT16
+template class graph_csr<uint32_t, uint32_t, float16>;
+template class graph_csr<uint32_t, uint64_t, float16>;
+#endif
+
+std::vector<float>
+par_page_rank_csr(const std::string &rank_type, const unsigned int &n,
+                  const std::vector<std::pair<unsigned int, unsigned int>> &edges, float beta,
+                  unsigned int max_iterations, double tolerance, int n_thread) {
+    if (rank_type == rank_type_name<double>())
+        return par_page_rank_csr<double>(n, edges, beta, max_iterations, tolerance, n_thread);
+    if (rank_type == rank_type_name<float>())
+        return par_page_rank_csr<float>(n, edges, beta, max_iterations, tolerance, n_thread);
+    if (rank_type == rank_type_name<bfloat16>())
+        return par_page_rank_csr<bfloat16>(n, edges, beta, max_iterations, tolerance, n_thread);
+#ifdef GRAPH_HAS_FLOAT16
+    if (rank_type == rank_type_name<float16>())
+        return par_page_rank_csr<float16>(n, edges, beta, max_iterations, tolerance, n_thread);
+#endif
+
+    std::cerr << "Error: unknown rank type " << rank_type << std::endl;
+    exit(1);
+}
@@ -0,0 +1,74 @@
+#ifndef ASSIGNMENT_1_LMD_GRAPH_CSR_H
+#define ASSIGNMENT_1_LMD_GRAPH_CSR_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <limits>
+#include "rank_types.h"
+
+// row-wise (pull) compressed sparse graph, templated on the type of node ids, on the type of edge offsets and on the
+// storage type of the rank vector (double, float, bfloat16 or float16, the last two accumulated in float). Node ids
+// are read once per edge, so they stay 32-bit (the input ids are unsigned int); only the offsets, read once per node,
+// grow to uint64_t for graphs with more than 4 billion edges. Instantiated for these combinations in graph_csr.cpp
+template<typename Node, typename Offset, typename Rank>
+class graph_csr {
+public:
+    using accumulator = typename rank_accumulator<Rank>::type;
+
+private:
+    size_t n; // number of nodes
+    size_t m; // number of edges
+
+    std::vector<Offset> offsets;             // in-edges of node i are sources[offsets[i]..offsets[i + 1])
+    std::vector<Node> sources;
+    std::vector<accumulator> inv_out_degree; // 1 / o(j), 0 for dead ends
+    std::vector<Node> dead_ends;
+
+public:
+    graph_csr(const unsigned int &n, const std::vector<std::pair<unsigned int, unsigned int>> &edges);
+
+    // return the number of nodes
+    size_t get_n() const;
+
+    size_t get_m() const;
+
+    // the ranks are stored as n * r, so that they are around 1 and reduced precision types keep their digits; the scale
+    // is capped at rank_max_scale<Rank> so that hubs do not overflow float16 (above 32768 nodes its smallest stored
+    // ranks shrink as 32768 / n). iterations, if not null, receives the number of iterations done
+    std::vector<accumulator>
+    par_page_rank(const std::vector<float> &v, float beta, unsigned int max_iterations, double tolerance,
+                  int n_thread = -1, unsigned int *iterations = nullptr) const;
+};
+
+// true if the edge offsets of a graph with m edges fit in 32 bits
+inline bool fits_32_bit_offsets(size_t m) {
+    return m <= std::numeric_limits<uint32_t>::max();
+}
+
+// PageRank with the rank storage type chosen at compile time and the offset type chosen at runtime by graph size
+template<typename Rank>
+std::vector<float>
+par_page_rank_csr(const unsigned int &n, const std::vector<std::pair<unsigned int, unsigned int>> &edges, float beta,
+                  unsigned int max_iterations, double tolerance, int n_thread = -1) {
+    std::vector<float> r(n);
+    if (fits_32_bit_offsets(edges.size())) {
+        auto r_acc = graph_csr<uint32_t, uint32_t, Rank>(n, edges).par_page_rank(
+                std::vector<float>(n, 1.f / n), beta, max_iterations, tolerance, n_thread);
+        r.assign(r_acc.begin(), r_acc.end());
+    } else {
+        auto r_acc = graph_csr<uint32_t, uint64_t, Rank>(n, edges).par_page_rank(
+                std::vector<float>(n, 1.f / n), beta, max_iterations, tolerance, n_thread);
+        r.assign(r_acc.begin(), r_acc.end());
+    }
+
+    return r;
+}
+
+// same as above with the rank storage type chosen at runtime by name ("double", "float", "bfloat16" or "float16")
+std::vector<float>
+par_page_rank_csr(const std::string &rank_type, const unsigned int &n,
+                  const std::vector<std::pair<unsigned int, unsigned int>> &edges, float beta,
+                  unsigned int max_iterations, double tolerance, int n_thread = -1);
+
+#endif //ASSIGNMENT_1_LMD_GRAPH_CSR_H
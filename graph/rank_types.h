@@ -0,0 +1,73 @@
+#ifndef ASSIGNMENT_1_LMD_RANK_TYPES_H
+#define ASSIGNMENT_1_LMD_RANK_TYPES_H
+
+#include <bit>
+#include <cstdint>
+#include <string>
+
+// reduced-precision storage types for the rank vector; arithmetic is always done in the accumulator type
+
+// bfloat16: the upper 16 bits of a float, rounded to nearest even
+struct bfloat16 {
+    uint16_t bits;
+
+    bfloat16() = default;
+
+    bfloat16(float f) {
+        uint32_t u = std::bit_cast<uint32_t>(f);
+        u += 0x7FFF + ((u >> 16) & 1);
+        bits = static_cast<uint16_t>(u >> 16);
+    }
+
+    operator float() const {
+        return std::bit_cast<float>(static_cast<uint32_t>(bits) << 16);
+    }
+};
+
+// IEEE half precision, when the compiler supports it
+#ifdef __FLT16_MAX__
+#define GRAPH_HAS_FLOAT16
+using float16 = _Float16;
+#endif
+
+// type used to accumulate the contributions of a rank storage type
+template<typename Rank>
+struct rank_accumulator {
+    using type = float;
+};
+
+template<>
+struct rank_accumulator<double> {
+    using type = double;
+};
+
+// largest scale of the stored ranks: a rank is at most 1, so a scale of half the largest finite value keeps every stored
+// rank finite, also after rounding. No cap for the types with the range of float
+template<typename Rank>
+struct rank_max_scale {
+    static constexpr double value = 1e300;
+};
+
+template<typename Rank>
+std::string rank_type_name();
+
+template<>
+inline std::string rank_type_name<double>() { return "double"; }
+
+template<>
+inline std::string rank_type_name<float>() { return "float"; }
+
+template<>
+inline std::string rank_type_name<bfloat16>() { return "bfloat16"; }
+
+#ifdef GRAPH_HAS_FLOAT16
+template<>
+struct rank_max_scale<float16> {
+    static constexpr double value = 32768; // largest finite float16 is 65504
+};
+
+template<>
+inline std::string rank_type_name<float16>() { return "float16"; }
+#endif
+
+#endif //ASSIGNMENT_1_LMD_RANK_TYPES_H
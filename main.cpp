@@ -4,13 +4,21 @@
 #include <omp.h>
 #include <fstream>
 #include <numeric>
+#include <cmath>
+#include <algorithm>
 #include "graph/graph.h"
 #include "graph/graph_by_row.h"
+#include "graph/graph_bitmap.h"
+#include "graph/graph_csr.h"
 #include "utility.h"
+#include "results.h"
+#include "checkpoint.h"
 
 int main(int argc, char *argv[]) {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <filename> <max_num_thread_stats (optional)>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <filename> <max_num_thread_stats (optional)> <output_prefix (optional)>"
+                  << " <checkpoint_file (optional)> <rank_type (optional, double, float, bfloat16 or float16)>"
+                  << std::endl;
         return 1;
     }
 
@@ -18,7 +26,9 @@ int main(int argc, char *argv[]) {
     std::cout << "File: " << filename << std::endl;
     std::cout << "Parsing file..." << std::endl;
 
-    std::vector<std::pair<unsigned int, unsigned int>> edges = utility::parse_edges_from_file_and_normalize(filename);
+    std::vector<unsigned int> original_ids;
+    std::vector<std::pair<unsigned int, unsigned int>> edges =
+            utility::parse_edges_from_file_and_normalize(filename, original_ids);
     unsigned int n = 0;
     for (auto &edge: edges) {
         n = std::max(n, std::max(edge.first, edge.second));
@@ -30,6 +40,93 @@ int main(int argc, char *argv[]) {
     std::cout << "Number of edges: " << edges.size() << std::endl;
     std::cout << "Number of threads available: " << omp_get_max_threads() << std::endl << std::endl;
 
+    std::string filename_no_ext = filename.substr(filename.find_last_of('/') + 1,
+                                                  filename.find_last_of('.') - filename.find_last_of('/') - 1);
+    int max_n_threads = argc > 2 ? std::stoi(argv[2]) : -1;
+
+    // dense graphs: the bit matrix is built instead of the neighbour lists, so only the plain solver is available
+    if (graph_bitmap::is_dense(n, edges.size())) {
+        auto begin = std::chrono::high_resolution_clock::now();
+        graph_bitmap g_bitmap(n, edges);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "Number of dead ends: " << g_bitmap.get_num_dead_ends() << std::endl;
+        std::cout << "Density: " << g_bitmap.get_density() << std::endl;
+        std::cout << "Bitmap graph creation time: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count()
+                  << "ms" << std::endl;
+
+        std::cout << std::endl << "Running sequential and parallel page rank on the bitmap graph..." << std::endl;
+
+        begin = std::chrono::high_resolution_clock::now();
+        std::vector<float> r_seq = g_bitmap.seq_page_rank(std::vector<float>(n, 1.0 / n), 0.85, 50, 1e-7);
+        end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "Sequential time: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count()
+                  << "ms" << std::endl;
+
+        begin = std::chrono::high_resolution_clock::now();
+        std::vector<float> r_par = g_bitmap.par_page_rank(std::vector<float>(n, 1.0 / n), 0.85, 50, 1e-7, -1);
+        end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "Parallel time: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count()
+                  << "ms" << std::endl;
+
+        // the sequential run shares the kernel, check against an independent solver on the same edges instead: the
+        // compressed row-wise graph in double precision, which does not build the neighbour lists either
+        begin = std::chrono::high_resolution_clock::now();
+        std::vector<float> r_reference = par_page_rank_csr<double>(n, edges, 0.85, 50, 1e-7);
+        end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "Reference (compressed graph, double) parallel time: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "ms" << std::endl;
+
+        // compare results
+        if (!utility::compare_vectors(r_reference, r_par)) {
+            std::cerr << "Results are different!" << std::endl;
+            return 1;
+        }
+
+        std::cout << "Results are equal!" << std::endl;
+
+        if (argc > 4)
+            std::cout << "The checkpointed solve needs the neighbour lists, skipped on the bitmap graph" << std::endl;
+
+        // save ranks with the original node ids
+        if (argc > 3) {
+            std::string prefix(argv[3]);
+
+            begin = std::chrono::high_resolution_clock::now();
+            results::write_csv(prefix + ".csv", r_par, original_ids);
+            results::write_binary(prefix + ".bin", r_par, original_ids);
+            results::write_csv(prefix + "_top1000.csv", results::top_k(r_par, 1000), original_ids);
+            end = std::chrono::high_resolution_clock::now();
+
+            std::cout << "Ranks saved to " << prefix << ".csv, " << prefix << ".bin and " << prefix << "_top1000.csv in "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "ms" << std::endl;
+        }
+
+        std::cout << std::endl << "Computing speedup up to " << max_n_threads << " threads..." << std::endl;
+
+        auto stats = utility::get_stats_pagerank(g_bitmap, max_n_threads);
+
+        // Create file and save speedup
+        std::ofstream file{"../stats/pagerank_speedup_" + filename_no_ext + "_bitmap.csv"};
+
+        std::cout << "Speedup computed! Saving to file "
+                  << "../stats/pagerank_speedup_" + filename_no_ext + "_bitmap.csv" << std::endl;
+
+        file << "n_thread,milliseconds" << std::endl;
+        for (auto &p: stats["pagerank_speedup"]) {
+            file << p.first << "," << p.second << std::endl;
+        }
+        file.close();
+
+        std::cout << "File saved!" << std::endl;
+
+        return 0;
+    }
+
     auto begin = std::chrono::high_resolution_clock::now();
     graph g(n, edges);
     auto end = std::chrono::high_resolution_clock::now();
@@ -66,14 +163,128 @@ int main(int argc, char *argv[]) {
 
     std::cout << "Results are equal!" << std::endl;
 
-    int max_n_threads = argc > 2 ? std::stoi(argv[2]) : -1;
+    begin = std::chrono::high_resolution_clock::now();
+    std::vector<float> r_dangling = g.par_page_rank_dangling(std::vector<float>(n, 1.0 / n), 0.85, 50, 1e-7, -1);
+    end = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Dangling elimination parallel time: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "ms" << std::endl;
+
+    // compare results
+    if (!utility::compare_vectors(r_dangling, r_par)) {
+        std::cerr << "Results are different!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Results are equal!" << std::endl;
+
+    begin = std::chrono::high_resolution_clock::now();
+    std::vector<float> r_scc = g.par_page_rank_scc(std::vector<float>(n, 1.0 / n), 0.85, 50, 1e-7, -1);
+    end = std::chrono::high_resolution_clock::now();
+
+    std::cout << "SCC BlockRank parallel time: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "ms" << std::endl;
+
+    // compare results
+    if (!utility::compare_vectors(r_scc, r_par)) {
+        std::cerr << "Results are different!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Results are equal!" << std::endl;
+
+    // compressed row-wise graph: rank storage type from the command line, offset type chosen by the graph size
+    std::string rank_type = argc > 5 ? argv[5] : "float";
+    begin = std::chrono::high_resolution_clock::now();
+    std::vector<float> r_csr = par_page_rank_csr(rank_type, n, edges, 0.85, 50, 1e-7, -1);
+    end = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Compressed graph (" << rank_type << " ranks, "
+              << (fits_32_bit_offsets(edges.size()) ? "32" : "64") << "-bit offsets) parallel time: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "ms" << std::endl;
+
+    // compare results
+    if (!utility::compare_vectors(r_csr, r_par)) {
+        std::cerr << "Results are different!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Results are equal!" << std::endl;
+
+    begin = std::chrono::high_resolution_clock::now();
+    std::vector<float> r_monte_carlo = g.par_page_rank_monte_carlo(0.85, 50, 1000);
+    end = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Monte Carlo parallel time: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "ms" << std::endl;
+
+    // the approximation is not expected to match within compare_vectors tolerance, report the L1 error instead
+    double l1_error = 0;
+    for (unsigned int i = 0; i < n; ++i)
+        l1_error += std::abs(r_monte_carlo[i] - r_par[i]);
+    std::cout << "Monte Carlo L1 error: " << l1_error << std::endl;
+
+    auto top_par = results::top_k(r_par, 1000), top_monte_carlo = results::top_k(r_monte_carlo, 1000);
+    std::vector<unsigned int> top_ids_par, top_ids_monte_carlo, common;
+    for (unsigned int k = 0; k < top_par.size(); ++k) {
+        top_ids_par.push_back(top_par[k].first);
+        top_ids_monte_carlo.push_back(top_monte_carlo[k].first);
+    }
+    std::sort(top_ids_par.begin(), top_ids_par.end());
+    std::sort(top_ids_monte_carlo.begin(), top_ids_monte_carlo.end());
+    std::set_intersection(top_ids_par.begin(), top_ids_par.end(), top_ids_monte_carlo.begin(),
+                          top_ids_monte_carlo.end(), std::back_inserter(common));
+    std::cout << "Monte Carlo top-" << top_par.size() << " overlap: " << common.size() << std::endl;
+
+    // checkpointed solve, warm started from the ranks saved by a previous run when available
+    if (argc > 4) {
+        std::vector<float> v = checkpoint::warm_start(std::string(argv[3]) + ".bin", original_ids);
+        bool warm = !v.empty(), resumed = false;
+        if (!warm)
+            v = std::vector<float>(n, 1.0 / n);
+
+        begin = std::chrono::high_resolution_clock::now();
+        std::vector<float> r_checkpointed = g.par_page_rank_checkpointed(v, 0.85, 50, 1e-7, argv[4], 10, -1,
+                                                                         &resumed);
+        end = std::chrono::high_resolution_clock::now();
+
+        // an unfinished checkpoint takes precedence over the ranks of the previous run
+        if (resumed)
+            std::cout << "Checkpointed solve resumed from " << argv[4] << std::endl;
+        else
+            std::cout << (warm ? "Warm" : "Cold") << " start of the checkpointed solve" << std::endl;
+
+        std::cout << "Checkpointed parallel time: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "ms" << std::endl;
+
+        // compare results
+        if (!utility::compare_vectors(r_checkpointed, r_par)) {
+            std::cerr << "Results are different!" << std::endl;
+            return 1;
+        }
+
+        std::cout << "Results are equal!" << std::endl;
+    }
+
+    // save ranks with the original node ids
+    if (argc > 3) {
+        std::string prefix(argv[3]);
+
+        begin = std::chrono::high_resolution_clock::now();
+        results::write_csv(prefix + ".csv", r_par, original_ids);
+        results::write_binary(prefix + ".bin", r_par, original_ids);
+        results::write_csv(prefix + "_top1000.csv", top_par, original_ids);
+        end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "Ranks saved to " << prefix << ".csv, " << prefix << ".bin and " << prefix << "_top1000.csv in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "ms" << std::endl;
+    }
+
     std::cout << std::endl << "Computing speedup up to " << max_n_threads << " threads..." << std::endl;
 
     auto stats = utility::get_stats_pagerank(g, max_n_threads);
 
     // Create file and save speedup
-    std::string filename_no_ext = filename.substr(filename.find_last_of('/') + 1,
-                                                  filename.find_last_of('.') - filename.find_last_of('/') - 1);
     std::ofstream file{"../stats/pagerank_speedup_" + filename_no_ext + ".csv"};
 
     std::cout << "Speedup computed! Saving to file " << "../stats/pagerank_speedup_" + filename_no_ext + ".csv"
@@ -126,6 +337,21 @@ int main(int argc, char *argv[]) {
 
     std::cout << "Results are equal!" << std::endl;
 
+    begin = std::chrono::high_resolution_clock::now();
+    std::vector<float> r_adaptive = g_by_row.par_page_rank_adaptive(std::vector<float>(n, 1.0 / n), 0.85, 50, 1e-7);
+    end = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Adaptive parallel time: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "ms" << std::endl;
+
+    // compare results
+    if (!utility::compare_vectors(r_adaptive, r_par)) {
+        std::cerr << "Results are different!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Results are equal!" << std::endl;
+
     std::cout << std::endl << "Computing speedup up to " << max_n_threads << " threads..." << std::endl;
 
     stats = utility::get_stats_pagerank(g_by_row, max_n_threads);
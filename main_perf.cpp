@@ -4,10 +4,15 @@
 #include "utility.h"
 #include "graph/graph.h"
 #include "graph/graph_by_row.h"
+#include "graph/graph_bitmap.h"
+#include "graph/graph_csr.h"
+#include "tuner.h"
 
 int main(int argc, char *argv[]) {
     if (argc < 4) {
-        std::cerr << "Usage: " << argv[0] << " <filename> <graph_type (a or b)> <algorithm_type (p or s)>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <filename> <graph_type (a, b, c for compressed or t for auto-tuned)>"
+                  << " <algorithm_type (p or s)> <rank_type (optional for c: double, float, bfloat16 or float16)>"
+                  << std::endl;
         return 1;
     }
 
@@ -24,7 +29,36 @@ int main(int argc, char *argv[]) {
 
     std::cout << "File parsed!" << std::endl << std::endl;
 
-    if (argv[2][0] == 'a') {
+    if (argv[2][0] == 't') {
+        // engine, threads and chunk chosen by the tuner, cached per graph; only the chosen engine is built
+        tuner::configuration c = tuner::get_configuration(n, edges, "../stats/tuner_cache.txt");
+        std::cout << "Tuned configuration: " << tuner::to_string(c.e) << ", " << c.n_thread << " threads, chunk "
+                  << c.chunk_size << std::endl;
+
+        if (c.e == tuner::engine::graph) {
+            graph g(n, edges);
+            g.par_page_rank(std::vector<float>(n, static_cast<float>(1) / n), 0.85, 50, 1e-7, c.n_thread,
+                            c.chunk_size);
+        } else if (c.e == tuner::engine::graph_by_row) {
+            graph_by_row gbr(n, edges);
+            gbr.par_page_rank(std::vector<float>(n, static_cast<float>(1) / n), 0.85, 50, 1e-7, c.n_thread,
+                              c.chunk_size);
+        } else {
+            graph_bitmap gb(n, edges);
+            gb.par_page_rank(std::vector<float>(n, static_cast<float>(1) / n), 0.85, 50, 1e-7, c.n_thread);
+        }
+    } else if (argv[2][0] == 'c') {
+        // compressed row-wise graph, offset type chosen by the graph size
+        par_page_rank_csr(argc > 4 ? argv[4] : "float", n, edges, 0.85, 50, 1e-7, argv[3][0] == 'p' ? -1 : 1);
+    } else if (argv[2][0] == 'a' && graph_bitmap::is_dense(n, edges.size())) {
+        // dense graphs: the bit matrix replaces the neighbour lists
+        graph_bitmap gb(n, edges);
+        if (argv[3][0] == 'p') {
+            gb.par_page_rank(std::vector<float>(n, static_cast<float>(1) / n), 0.85, 50, 1e-7, -1);
+        } else {
+            gb.seq_page_rank(std::vector<float>(n, static_cast<float>(1) / n), 0.85, 50, 1e-7);
+        }
+    } else if (argv[2][0] == 'a') {
         graph g(n, edges);
         if (argv[3][0] == 'p') {
             g.par_page_rank(std::vector<float>(n, static_cast<float>(1) / n), 0.85, 50, 1e-7, -1);
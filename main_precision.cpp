@@ -0,0 +1,119 @@
+#include <iostream>
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include "utility.h"
+#include "results.h"
+#include "graph/graph_csr.h"
+
+// runs one offset/rank type combination (node ids are always 32-bit) and reports its throughput and its error against
+// the reference
+template<typename Offset, typename Rank>
+void run_variant(const unsigned int &n, const std::vector<std::pair<unsigned int, unsigned int>> &edges,
+                 const std::vector<double> &reference, std::ofstream &file) {
+    graph_csr<uint32_t, Offset, Rank> g(n, edges);
+
+    unsigned int iterations;
+    auto begin = std::chrono::high_resolution_clock::now();
+    auto r_acc = g.par_page_rank(std::vector<float>(n, 1.f / n), 0.85, 50, 1e-7, -1, &iterations);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::vector<float> r(r_acc.begin(), r_acc.end());
+
+    double milliseconds = std::chrono::duration<double, std::milli>(end - begin).count();
+    double edges_per_second = static_cast<double>(g.get_m()) * iterations / (milliseconds / 1000);
+    std::string offset_name = sizeof(Offset) == 4 ? "uint32" : "uint64";
+
+    // a storage type that overflowed or underflowed to nan is a failed variant, not a large error
+    if (!std::all_of(r.begin(), r.end(), [](float x) { return std::isfinite(x); })) {
+        std::cout << offset_name << "/" << rank_type_name<Rank>() << ": failed, non-finite ranks after " << iterations
+                  << " iterations" << std::endl;
+
+        file << offset_name << "," << rank_type_name<Rank>() << "," << iterations << "," << milliseconds << ","
+             << edges_per_second / 1e6 << ",,,,failed" << std::endl;
+        return;
+    }
+
+    double l1_error = 0, max_error = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+        double error = std::abs(r[i] - reference[i]);
+        l1_error += error;
+        max_error = std::max(max_error, error);
+    }
+
+    // overlap of the top 100 nodes with the reference ones
+    std::vector<float> reference_float(reference.begin(), reference.end());
+    auto top = results::top_k(r, 100), top_reference = results::top_k(reference_float, 100);
+    std::vector<unsigned int> ids, ids_reference, common;
+    for (unsigned int k = 0; k < top.size(); ++k) {
+        ids.push_back(top[k].first);
+        ids_reference.push_back(top_reference[k].first);
+    }
+    std::sort(ids.begin(), ids.end());
+    std::sort(ids_reference.begin(), ids_reference.end());
+    std::set_intersection(ids.begin(), ids.end(), ids_reference.begin(), ids_reference.end(),
+                          std::back_inserter(common));
+
+    std::cout << offset_name << "/" << rank_type_name<Rank>() << ": " << iterations << " iterations, "
+              << milliseconds << "ms, " << edges_per_second / 1e6 << " Medges/s, L1 error " << l1_error
+              << ", max error " << max_error << ", top-100 overlap " << common.size() << std::endl;
+
+    file << offset_name << "," << rank_type_name<Rank>() << "," << iterations << "," << milliseconds << ","
+         << edges_per_second / 1e6 << "," << l1_error << "," << max_error << "," << common.size() << ",ok" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <filename>" << std::endl;
+        return 1;
+    }
+
+    std::string filename(argv[1]);
+    std::cout << "File: " << filename << std::endl;
+    std::cout << "Parsing file..." << std::endl;
+
+    std::vector<std::pair<unsigned int, unsigned int>> edges = utility::parse_edges_from_file_and_normalize(filename);
+    unsigned int n = 0;
+    for (auto &edge: edges) {
+        n = std::max(n, std::max(edge.first, edge.second));
+    }
+    n++;
+
+    std::cout << "File parsed!" << std::endl << std::endl;
+    std::cout << "Number of nodes: " << n << std::endl;
+    std::cout << "Number of edges: " << edges.size() << std::endl;
+    std::cout << "Number of threads available: " << omp_get_max_threads() << std::endl;
+    std::cout << "Offset type selected by size: " << (fits_32_bit_offsets(edges.size()) ? "uint32" : "uint64")
+              << std::endl << std::endl;
+
+    // double precision reference, iterated well past the tolerance of the variants
+    std::vector<double> reference = graph_csr<uint32_t, uint64_t, double>(n, edges).par_page_rank(
+            std::vector<float>(n, 1.f / n), 0.85, 200, 1e-12);
+
+    std::string filename_no_ext = filename.substr(filename.find_last_of('/') + 1,
+                                                  filename.find_last_of('.') - filename.find_last_of('/') - 1);
+    std::ofstream file{"../stats/pagerank_precision_" + filename_no_ext + ".csv"};
+    file << "offset,rank,iterations,milliseconds,medges_per_second,l1_error,max_error,top100_overlap,status"
+         << std::endl;
+
+    run_variant<uint32_t, double>(n, edges, reference, file);
+    run_variant<uint32_t, float>(n, edges, reference, file);
+    run_variant<uint32_t, bfloat16>(n, edges, reference, file);
+#ifdef GRAPH_HAS_FLOAT16
+    run_variant<uint32_t, float16>(n, edges, reference, file);
+#endif
+    run_variant<uint64_t, double>(n, edges, reference, file);
+    run_variant<uint64_t, float>(n, edges, reference, file);
+    run_variant<uint64_t, bfloat16>(n, edges, reference, file);
+#ifdef GRAPH_HAS_FLOAT16
+    run_variant<uint64_t, float16>(n, edges, reference, file);
+#endif
+
+    file.close();
+    std::cout << std::endl << "Results saved to ../stats/pagerank_precision_" + filename_no_ext + ".csv" << std::endl;
+
+    return 0;
+}
@@ -5,7 +5,9 @@
 #include <fstream>
 #include "graph/graph.h"
 #include "graph/graph_by_row.h"
+#include "graph/graph_bitmap.h"
 #include "utility.h"
+#include "tuner.h"
 
 int main(int argc, char *argv[]) {
     if (argc < 2) {
@@ -30,20 +32,31 @@ int main(int argc, char *argv[]) {
     std::cout << "Number of edges: " << edges.size() << std::endl;
     std::cout << "Number of threads available: " << omp_get_max_threads() << std::endl << std::endl;
 
-    auto begin = std::chrono::high_resolution_clock::now();
-    graph g(n, edges);
-    auto end = std::chrono::high_resolution_clock::now();
-
-    std::cout << "Number of dead ends: " << g.get_num_dead_ends() << std::endl;
-    std::cout << "Graph creation time: "
-              << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count()
-              << "ms" << std::endl;
+    // engine, threads and chunk chosen by the tuner, cached per graph, so that the trace shows the configuration that
+    // is actually used; only the chosen engine is built (the bit matrix on dense graphs)
+    tuner::configuration c = tuner::get_configuration(n, edges, "../stats/tuner_cache.txt");
+    std::cout << "Tuned configuration: " << tuner::to_string(c.e) << ", " << c.n_thread << " threads, chunk "
+              << c.chunk_size << std::endl;
 
     std::cout << std::endl << "Running parallel page rank..." << std::endl;
 
-    begin = std::chrono::high_resolution_clock::now();
-    std::vector<float> r_seq = g.par_page_rank(std::vector<float>(n, 1.0 / n), 0.85, 50, 1e-7, -1);
-    end = std::chrono::high_resolution_clock::now();
+    std::chrono::high_resolution_clock::time_point begin, end;
+    if (c.e == tuner::engine::graph_bitmap) {
+        graph_bitmap g(n, edges);
+        begin = std::chrono::high_resolution_clock::now();
+        g.par_page_rank(std::vector<float>(n, 1.0 / n), 0.85, 50, 1e-7, c.n_thread);
+        end = std::chrono::high_resolution_clock::now();
+    } else if (c.e == tuner::engine::graph_by_row) {
+        graph_by_row g(n, edges);
+        begin = std::chrono::high_resolution_clock::now();
+        g.par_page_rank(std::vector<float>(n, 1.0 / n), 0.85, 50, 1e-7, c.n_thread, c.chunk_size);
+        end = std::chrono::high_resolution_clock::now();
+    } else {
+        graph g(n, edges);
+        begin = std::chrono::high_resolution_clock::now();
+        g.par_page_rank(std::vector<float>(n, 1.0 / n), 0.85, 50, 1e-7, c.n_thread, c.chunk_size);
+        end = std::chrono::high_resolution_clock::now();
+    }
 
     std::cout << "Parallel time: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count()
               << "ms"
@@ -0,0 +1,57 @@
+#include <iostream>
+#include <chrono>
+#include <csignal>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include "utility.h"
+#include "graph/graph.h"
+#include "server/pagerank_server.h"
+
+pagerank_server *server = nullptr;
+
+void handle_signal(int) {
+    if (server != nullptr)
+        server->stop();
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <filename> <socket_path> <cache_capacity (optional)>" << std::endl;
+        return 1;
+    }
+
+    std::string filename(argv[1]);
+    std::cout << "File: " << filename << std::endl;
+    std::cout << "Parsing file..." << std::endl;
+
+    std::vector<unsigned int> original_ids;
+    std::vector<std::pair<unsigned int, unsigned int>> edges =
+            utility::parse_edges_from_file_and_normalize(filename, original_ids);
+    unsigned int n = original_ids.size();
+
+    auto begin = std::chrono::high_resolution_clock::now();
+    graph g(n, edges);
+    auto end = std::chrono::high_resolution_clock::now();
+    edges.clear();
+    edges.shrink_to_fit();
+
+    std::cout << "File parsed!" << std::endl << std::endl;
+    std::cout << "Number of nodes: " << n << std::endl;
+    std::cout << "Number of edges: " << g.get_m() << std::endl;
+    std::cout << "Number of threads available: " << omp_get_max_threads() << std::endl;
+    std::cout << "Graph creation time: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count()
+              << "ms" << std::endl << std::endl;
+
+    pagerank_server s(g, original_ids, argc > 3 ? std::stoul(argv[3]) : 64);
+    server = &s;
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+
+    std::cout << "Listening on " << argv[2] << std::endl;
+    s.run(argv[2]);
+    std::cout << "Server stopped" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,213 @@
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <omp.h>
+#include "results.h"
+
+namespace results {
+    // nodes per block written by the streaming writers
+    const unsigned int block_size = 1 << 20;
+
+    const char binary_magic[4] = {'P', 'R', 'N', 'K'};
+    const uint32_t binary_version = 1;
+
+    // higher rank first, ties broken by the smaller id
+    static bool ranks_before(const std::pair<unsigned int, float> &a, const std::pair<unsigned int, float> &b) {
+        return a.second > b.second || (a.second == b.second && a.first < b.first);
+    }
+
+    static unsigned int original_id(const std::vector<unsigned int> &original_ids, unsigned int i) {
+        return original_ids.empty() ? i : original_ids[i];
+    }
+
+    template<typename T>
+    static void append_number(std::string &buffer, T value, char separator) {
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer.append(digits, result.ptr);
+        buffer.push_back(separator);
+    }
+
+    static std::ofstream open_output(const std::string &filename, std::ios::openmode mode = std::ios::out) {
+        std::ofstream file(filename, mode);
+        if (!file.is_open()) {
+            std::cerr << "Error: cannot open file " << filename << std::endl;
+            exit(1);
+        }
+
+        return file;
+    }
+
+    std::vector<std::pair<unsigned int, float>> top_k(const std::vector<float> &r, unsigned int k, int n_thread) {
+        // If n_thread is -1, use all available threads
+        if (n_thread == -1) {
+            n_thread = omp_get_max_threads();
+        }
+
+        k = std::min<size_t>(k, r.size());
+        std::vector<std::pair<unsigned int, float>> merged;
+        if (k == 0)
+            return merged;
+
+        // every thread keeps a heap of its best k nodes (the worst one on top), the heaps are then merged
+#pragma omp parallel if(n_thread != 1) num_threads(n_thread) default(none) shared(r, k, merged)
+        {
+            std::vector<std::pair<unsigned int, float>> heap;
+            heap.reserve(k);
+
+#pragma omp for schedule(static) nowait
+            for (unsigned int i = 0; i < r.size(); ++i) {
+                std::pair<unsigned int, float> node{i, r[i]};
+                if (heap.size() < k) {
+                    heap.push_back(node);
+                    std::push_heap(heap.begin(), heap.end(), ranks_before);
+                } else if (ranks_before(node, heap.front())) {
+                    std::pop_heap(heap.begin(), heap.end(), ranks_before);
+                    heap.back() = node;
+                    std::push_heap(heap.begin(), heap.end(), ranks_before);
+                }
+            }
+
+#pragma omp critical
+            merged.insert(merged.end(), heap.begin(), heap.end());
+        }
+
+        std::partial_sort(merged.begin(), merged.begin() + k, merged.end(), ranks_before);
+        merged.resize(k);
+
+        return merged;
+    }
+
+    void write_csv(const std::string &filename, const std::vector<float> &r,
+                   const std::vector<unsigned int> &original_ids, int n_thread) {
+        // If n_thread is -1, use all available threads
+        if (n_thread == -1) {
+            n_thread = omp_get_max_threads();
+        }
+
+        std::ofstream file = open_output(filename);
+        file << "id,pagerank\n";
+
+        // each block is split into one sub-block per requested thread, formatted into its own buffer and written in
+        // order; the sub-blocks do not depend on the size of the team actually granted by the runtime
+        unsigned int n_slices = n_thread;
+        std::vector<std::string> buffers(n_slices);
+        for (size_t first = 0; first < r.size(); first += block_size) {
+            size_t last = std::min(first + block_size, r.size());
+            size_t chunk = (last - first + n_slices - 1) / n_slices;
+
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+        shared(r, original_ids, buffers, first, last, chunk, n_slices) schedule(dynamic, 1)
+            for (unsigned int s = 0; s < n_slices; ++s) {
+                size_t begin = std::min(first + s * chunk, last), end = std::min(begin + chunk, last);
+
+                std::string &buffer = buffers[s];
+                buffer.clear();
+                buffer.reserve((end - begin) * 24);
+
+                for (size_t i = begin; i < end; ++i) {
+                    append_number(buffer, original_id(original_ids, i), ',');
+                    append_number(buffer, r[i], '\n');
+                }
+            }
+
+            for (auto &buffer: buffers)
+                file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        }
+
+        file.close();
+    }
+
+    void write_csv(const std::string &filename, const std::vector<std::pair<unsigned int, float>> &ranked,
+                   const std::vector<unsigned int> &original_ids) {
+        std::ofstream file = open_output(filename);
+        file << "rank,id,pagerank\n";
+
+        std::string buffer;
+        for (size_t k = 0; k < ranked.size(); ++k) {
+            append_number(buffer, k + 1, ',');
+            append_number(buffer, original_id(original_ids, ranked[k].first), ',');
+            append_number(buffer, ranked[k].second, '\n');
+        }
+
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        file.close();
+    }
+
+    struct binary_record {
+        uint32_t id;
+        float pagerank;
+    };
+
+    static void write_binary_header(std::ofstream &file, uint64_t count) {
+        file.write(binary_magic, sizeof(binary_magic));
+        file.write(reinterpret_cast<const char *>(&binary_version), sizeof(binary_version));
+        file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    }
+
+    void write_binary(const std::string &filename, const std::vector<float> &r,
+                      const std::vector<unsigned int> &original_ids, int n_thread) {
+        // If n_thread is -1, use all available threads
+        if (n_thread == -1) {
+            n_thread = omp_get_max_threads();
+        }
+
+        std::ofstream file = open_output(filename, std::ios::out | std::ios::binary);
+        write_binary_header(file, r.size());
+
+        std::vector<binary_record> records(std::min<size_t>(block_size, r.size()));
+        for (size_t first = 0; first < r.size(); first += block_size) {
+            size_t count = std::min<size_t>(block_size, r.size() - first);
+
+#pragma omp parallel for if(n_thread != 1) num_threads(n_thread) default(none) \
+        shared(r, original_ids, records, first, count)
+            for (size_t k = 0; k < count; ++k)
+                records[k] = {original_id(original_ids, first + k), r[first + k]};
+
+            file.write(reinterpret_cast<const char *>(records.data()),
+                       static_cast<std::streamsize>(count * sizeof(binary_record)));
+        }
+
+        file.close();
+    }
+
+    void write_binary(const std::string &filename, const std::vector<std::pair<unsigned int, float>> &ranked,
+                      const std::vector<unsigned int> &original_ids) {
+        std::ofstream file = open_output(filename, std::ios::out | std::ios::binary);
+        write_binary_header(file, ranked.size());
+
+        std::vector<binary_record> records(ranked.size());
+        for (size_t k = 0; k < ranked.size(); ++k)
+            records[k] = {original_id(original_ids, ranked[k].first), ranked[k].second};
+
+        file.write(reinterpret_cast<const char *>(records.data()),
+                   static_cast<std::streamsize>(records.size() * sizeof(binary_record)));
+        file.close();
+    }
+
+    bool read_binary(const std::string &filename, std::vector<std::pair<unsigned int, float>> &records) {
+        std::ifstream file(filename, std::ios::in | std::ios::binary);
+        char magic[4];
+        uint32_t version;
+        uint64_t count;
+        if (!file.is_open() || !file.read(magic, sizeof(magic)) || !std::equal(magic, magic + 4, binary_magic) ||
+            !file.read(reinterpret_cast<char *>(&version), sizeof(version)) || version != binary_version ||
+            !file.read(reinterpret_cast<char *>(&count), sizeof(count)))
+            return false;
+
+        std::vector<binary_record> buffer(count);
+        if (!file.read(reinterpret_cast<char *>(buffer.data()),
+                       static_cast<std::streamsize>(count * sizeof(binary_record))))
+            return false;
+
+        records.resize(count);
+        for (size_t k = 0; k < count; ++k)
+            records[k] = {buffer[k].id, buffer[k].pagerank};
+
+        return true;
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef ASSIGNMENT_1_LMD_RESULTS_H
+#define ASSIGNMENT_1_LMD_RESULTS_H
+
+#include <string>
+#include <vector>
+
+// ranked results of a PageRank run; node ids are the dense ones used by the graph classes and are mapped back to the
+// input ids through original_ids (as returned by utility::parse_edges_from_file_and_normalize, empty = identity)
+namespace results {
+    // the k nodes with the highest rank, sorted by decreasing rank (ties by increasing id)
+    std::vector<std::pair<unsigned int, float>> top_k(const std::vector<float> &r, unsigned int k, int n_thread = -1);
+
+    // "id,pagerank" for every node, formatted in parallel and streamed to disk block by block
+    void write_csv(const std::string &filename, const std::vector<float> &r,
+                   const std::vector<unsigned int> &original_ids, int n_thread = -1);
+
+    // "rank,id,pagerank" for the given ranked nodes
+    void write_csv(const std::string &filename, const std::vector<std::pair<unsigned int, float>> &ranked,
+                   const std::vector<unsigned int> &original_ids);
+
+    // binary format: "PRNK", uint32 version, uint64 count, then count (uint32 id, float pagerank) records,
+    // little endian as in memory
+    void write_binary(const std::string &filename, const std::vector<float> &r,
+                      const std::vector<unsigned int> &original_ids, int n_thread = -1);
+
+    void write_binary(const std::string &filename, const std::vector<std::pair<unsigned int, float>> &ranked,
+                      const std::vector<unsigned int> &original_ids);
+
+    // (original id, pagerank) records of a file saved by write_binary; returns false if it cannot be read
+    bool read_binary(const std::string &filename, std::vector<std::pair<unsigned int, float>> &records);
+}
+
+#endif //ASSIGNMENT_1_LMD_RESULTS_H
@@ -0,0 +1,355 @@
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <omp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "pagerank_server.h"
+#include "../results.h"
+
+pagerank_server::pagerank_server(const graph &g, const std::vector<unsigned int> &original_ids, size_t cache_capacity,
+                                 int n_thread)
+        : g(g), original_ids(original_ids), n_thread(n_thread), cache_capacity(std::max<size_t>(cache_capacity, 1)) {
+    // If n_thread is -1, use all available threads
+    if (this->n_thread == -1) {
+        this->n_thread = omp_get_max_threads();
+    }
+
+    for (unsigned int i = 0; i < original_ids.size(); ++i)
+        dense_ids[original_ids[i]] = i;
+}
+
+bool pagerank_server::parse_query(const std::string &line, query &q, std::string &error) const {
+    std::stringstream sline(line);
+    std::string type, ids;
+    sline >> type >> q.beta >> q.tolerance >> q.top_k;
+    if (sline.fail() || (type != "global" && type != "personalized")) {
+        error = "expected 'global <beta> <tolerance> <top_k>' or "
+                "'personalized <beta> <tolerance> <top_k> <id>[,<id>...]'";
+        return false;
+    }
+
+    if (!(q.beta > 0 && q.beta < 1) || !(q.tolerance > 0)) {
+        error = "beta must be in (0, 1) and tolerance positive";
+        return false;
+    }
+
+    q.seeds.clear();
+    if (type == "personalized") {
+        sline >> ids;
+        std::stringstream sids(ids);
+        std::string id;
+        while (std::getline(sids, id, ',')) {
+            unsigned int original;
+            std::stringstream sid(id);
+            sid >> original;
+            if (sid.fail() || !dense_ids.contains(original)) {
+                error = "unknown node id '" + id + "'";
+                return false;
+            }
+            q.seeds.push_back(dense_ids.at(original));
+        }
+
+        if (q.seeds.empty()) {
+            error = "personalized PageRank needs at least one node id";
+            return false;
+        }
+
+        std::sort(q.seeds.begin(), q.seeds.end());
+        q.seeds.erase(std::unique(q.seeds.begin(), q.seeds.end()), q.seeds.end());
+    }
+
+    std::ostringstream personalization, key;
+    if (q.seeds.empty()) {
+        personalization << "global";
+    } else {
+        personalization << "personalized";
+        for (auto &seed: q.seeds)
+            personalization << " " << seed;
+    }
+    q.personalization = personalization.str();
+
+    key << q.personalization << "|" << std::setprecision(9) << q.beta << "|" << q.tolerance;
+    q.key = key.str();
+
+    return true;
+}
+
+std::shared_ptr<pagerank_server::cache_entry> pagerank_server::cache_lookup(const std::string &key) {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto it = cache_map.find(key);
+    if (it == cache_map.end())
+        return nullptr;
+
+    // move to the front of the LRU list
+    cache_list.splice(cache_list.begin(), cache_list, it->second);
+    return *it->second;
+}
+
+std::shared_ptr<pagerank_server::cache_entry> pagerank_server::solve(const query &q, unsigned int top_k) {
+    unsigned int n = g.get_n();
+
+    // warm start from the cached solve with the same personalization and the closest beta, if close enough
+    std::shared_ptr<const std::vector<float>> start;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        float best = warm_start_beta_distance;
+        for (auto &entry: cache_list) {
+            if (entry->personalization == q.personalization && std::abs(entry->beta - q.beta) <= best) {
+                best = std::abs(entry->beta - q.beta);
+                start = entry->ranks;
+            }
+        }
+    }
+
+    std::vector<float> v = start != nullptr ? *start : std::vector<float>(n, static_cast<float>(1) / n);
+    auto entry = std::make_shared<cache_entry>();
+    entry->key = q.key;
+    entry->personalization = q.personalization;
+    entry->beta = q.beta;
+
+    if (q.seeds.empty()) {
+        entry->ranks = std::make_shared<const std::vector<float>>(
+                g.par_page_rank(v, q.beta, max_iterations, q.tolerance, n_thread));
+    } else {
+        std::vector<float> teleport(n, 0);
+        for (auto &seed: q.seeds)
+            teleport[seed] = static_cast<float>(1) / q.seeds.size();
+
+        entry->ranks = std::make_shared<const std::vector<float>>(
+                g.par_page_rank_personalized(v, teleport, q.beta, max_iterations, q.tolerance, n_thread));
+    }
+
+    entry->top = std::make_shared<const std::vector<std::pair<unsigned int, float>>>(
+            results::top_k(*entry->ranks, std::max(top_k, min_top_k), n_thread));
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (!cache_map.contains(q.key)) {
+        cache_list.push_front(entry);
+        cache_map[q.key] = cache_list.begin();
+
+        if (cache_list.size() > cache_capacity) {
+            // evict the least recently used entry
+            cache_map.erase(cache_list.back()->key);
+            cache_list.pop_back();
+        }
+    }
+
+    return entry;
+}
+
+std::shared_ptr<const std::vector<std::pair<unsigned int, float>>>
+pagerank_server::get_top(const std::shared_ptr<cache_entry> &entry, unsigned int top_k) {
+    std::shared_ptr<const std::vector<std::pair<unsigned int, float>>> top;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        top = entry->top;
+    }
+
+    if (top->size() >= std::min<size_t>(top_k, entry->ranks->size()))
+        return top;
+
+    // more nodes than ever requested before for this entry: extract them once and keep them. This runs on the
+    // connection thread, so it stays sequential instead of opening an OpenMP team per client
+    top = std::make_shared<const std::vector<std::pair<unsigned int, float>>>(
+            results::top_k(*entry->ranks, top_k, 1));
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (entry->top->size() < top->size())
+        entry->top = top;
+
+    return top;
+}
+
+std::string pagerank_server::answer(const std::string &line) {
+    auto begin = std::chrono::high_resolution_clock::now();
+
+    query q;
+    std::string error;
+    if (!parse_query(line, q, error))
+        return "error " + error + "\n";
+
+    std::shared_ptr<cache_entry> entry = cache_lookup(q.key);
+    bool cached = entry != nullptr;
+
+    if (!cached) {
+        auto pending = std::make_shared<pending_query>();
+        pending->q = q;
+        auto result = pending->result.get_future();
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            if (stopping)
+                return "error server is shutting down\n";
+            queue.push_back(pending);
+        }
+        queue_cv.notify_one();
+
+        try {
+            std::tie(entry, cached) = result.get();
+        } catch (const std::exception &e) {
+            return "error solve failed: " + std::string(e.what()) + "\n";
+        } catch (...) {
+            return "error solve failed\n";
+        }
+    }
+
+    auto top = get_top(entry, q.top_k);
+    unsigned int count = std::min<size_t>(q.top_k, top->size());
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::ostringstream response;
+    response << "ok " << cached << " " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
+             << " " << count << "\n";
+    for (unsigned int k = 0; k < count; ++k)
+        response << original_ids[(*top)[k].first] << " " << (*top)[k].second << "\n";
+
+    return response.str();
+}
+
+void pagerank_server::dispatch() {
+    while (true) {
+        std::vector<std::shared_ptr<pending_query>> batch;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_cv.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping && queue.empty())
+                return;
+
+            // wait a little to batch the requests of other callers
+            lock.unlock();
+            std::this_thread::sleep_for(batch_window);
+            lock.lock();
+
+            batch.assign(queue.begin(), queue.end());
+            queue.clear();
+        }
+
+        // identical requests of different callers share a single solve
+        std::unordered_map<std::string, std::vector<std::shared_ptr<pending_query>>> groups;
+        std::vector<std::string> order;
+        for (auto &pending: batch) {
+            if (!groups.contains(pending->q.key))
+                order.push_back(pending->q.key);
+            groups[pending->q.key].push_back(pending);
+        }
+
+        // every solve uses the whole OpenMP thread pool, one after the other
+        for (auto &key: order) {
+            auto &group = groups[key];
+            std::shared_ptr<cache_entry> entry = cache_lookup(key);
+            bool cached = entry != nullptr;
+
+            try {
+                if (!cached) {
+                    unsigned int top_k = 0;
+                    for (auto &pending: group)
+                        top_k = std::max(top_k, pending->q.top_k);
+                    entry = solve(group.front()->q, top_k);
+                }
+            } catch (...) {
+                // the callers get the error instead of waiting forever, the dispatcher keeps serving
+                for (auto &pending: group)
+                    pending->result.set_exception(std::current_exception());
+                continue;
+            }
+
+            for (auto &pending: group)
+                pending->result.set_value({entry, cached});
+        }
+    }
+}
+
+void pagerank_server::handle_client(int fd) {
+    std::string buffer;
+    char chunk[4096];
+    ssize_t received;
+    bool open = true;
+
+    while (open && (received = recv(fd, chunk, sizeof(chunk), 0)) > 0) {
+        buffer.append(chunk, received);
+
+        size_t newline;
+        while (open && (newline = buffer.find('\n')) != std::string::npos) {
+            std::string line = buffer.substr(0, newline);
+            buffer.erase(0, newline + 1);
+            if (line.empty())
+                continue;
+
+            std::string response = answer(line);
+            for (size_t sent = 0; sent < response.size();) {
+                ssize_t written = send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+                if (written <= 0) {
+                    open = false;
+                    break;
+                }
+                sent += written;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(client_mutex);
+    client_fds.erase(fd);
+    close(fd);
+    client_cv.notify_all();
+}
+
+void pagerank_server::run(const std::string &socket_path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: socket path too long " << socket_path << std::endl;
+        exit(1);
+    }
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socket_path.c_str());
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || listen(fd, 128) < 0) {
+        std::cerr << "Error: cannot listen on " << socket_path << ": " << std::strerror(errno) << std::endl;
+        exit(1);
+    }
+    listen_fd = fd;
+
+    std::thread dispatcher(&pagerank_server::dispatch, this);
+
+    while (!stopping) {
+        int client_fd = accept(fd, nullptr, nullptr);
+        if (client_fd < 0) {
+            if (errno == EINTR && !stopping)
+                continue;
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(client_mutex);
+        client_fds.insert(client_fd);
+        std::thread(&pagerank_server::handle_client, this, client_fd).detach();
+    }
+
+    // stop accepting new requests, let the dispatcher finish the queued ones, then close the connections
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_cv.notify_all();
+    dispatcher.join();
+
+    std::unique_lock<std::mutex> lock(client_mutex);
+    for (auto &client_fd: client_fds)
+        shutdown(client_fd, SHUT_RDWR);
+    client_cv.wait(lock, [this] { return client_fds.empty(); });
+
+    close(fd);
+    unlink(socket_path.c_str());
+}
+
+void pagerank_server::stop() {
+    stopping = true;
+    int fd = listen_fd;
+    if (fd >= 0)
+        shutdown(fd, SHUT_RDWR);
+}
@@ -0,0 +1,101 @@
+#ifndef ASSIGNMENT_1_LMD_PAGERANK_SERVER_H
+#define ASSIGNMENT_1_LMD_PAGERANK_SERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "../graph/graph.h"
+
+// long-running PageRank service on a graph loaded once; requests are read one per line from a Unix-domain socket:
+//   global <beta> <tolerance> <top_k>
+//   personalized <beta> <tolerance> <top_k> <id>[,<id>...]
+// ids are the ones of the input file. The answer is "ok <cached (0 or 1)> <microseconds> <count>" followed by count
+// "<id> <pagerank>" lines, or a single "error <message>" line
+class pagerank_server {
+private:
+    struct query {
+        float beta;
+        double tolerance;
+        unsigned int top_k;
+        std::vector<unsigned int> seeds; // sorted dense ids, empty for global PageRank
+        std::string personalization;     // textual form of seeds
+        std::string key;                 // personalization, beta and tolerance
+    };
+
+    struct cache_entry {
+        std::string key;
+        std::string personalization;
+        float beta;
+        std::shared_ptr<const std::vector<float>> ranks;
+        std::shared_ptr<const std::vector<std::pair<unsigned int, float>>> top; // grows on demand
+    };
+
+    struct pending_query {
+        query q;
+        std::promise<std::pair<std::shared_ptr<cache_entry>, bool>> result; // entry and whether it was cached
+    };
+
+    const graph &g;
+    const std::vector<unsigned int> &original_ids;
+    std::unordered_map<unsigned int, unsigned int> dense_ids;
+    int n_thread;
+
+    unsigned int max_iterations = 200;
+    unsigned int min_top_k = 1000;             // top nodes extracted with every solve
+    float warm_start_beta_distance = 0.05;     // a cached solve this close in beta is used as starting vector
+    std::chrono::microseconds batch_window{500};
+
+    // LRU cache, most recently used first
+    size_t cache_capacity;
+    std::list<std::shared_ptr<cache_entry>> cache_list;
+    std::unordered_map<std::string, std::list<std::shared_ptr<cache_entry>>::iterator> cache_map;
+    std::mutex cache_mutex;
+
+    // requests waiting for a solve, batched by the dispatcher
+    std::deque<std::shared_ptr<pending_query>> queue;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+
+    std::atomic<bool> stopping{false};
+    std::atomic<int> listen_fd{-1};
+    std::unordered_set<int> client_fds; // open connections, each one served by a detached thread
+    std::mutex client_mutex;
+    std::condition_variable client_cv;
+
+    bool parse_query(const std::string &line, query &q, std::string &error) const;
+
+    std::shared_ptr<cache_entry> cache_lookup(const std::string &key);
+
+    std::shared_ptr<cache_entry> solve(const query &q, unsigned int top_k);
+
+    std::shared_ptr<const std::vector<std::pair<unsigned int, float>>>
+    get_top(const std::shared_ptr<cache_entry> &entry, unsigned int top_k);
+
+    std::string answer(const std::string &line);
+
+    void dispatch();
+
+    void handle_client(int fd);
+
+public:
+    pagerank_server(const graph &g, const std::vector<unsigned int> &original_ids, size_t cache_capacity = 64,
+                    int n_thread = -1);
+
+    // serve until stop() is called
+    void run(const std::string &socket_path);
+
+    // only sets a flag and shuts the listening socket down, so it can be called from a signal handler
+    void stop();
+};
+
+#endif //ASSIGNMENT_1_LMD_PAGERANK_SERVER_H
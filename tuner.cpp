@@ -0,0 +1,210 @@
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <type_traits>
+#include <omp.h>
+#include "graph/graph.h"
+#include "graph/graph_by_row.h"
+#include "graph/graph_bitmap.h"
+#include "tuner.h"
+
+namespace tuner {
+    // graph_by_row is skipped when n * dead ends is more than this many times m
+    const double max_dead_end_work_ratio = 16;
+
+    // a chunk holding a hub takes much longer than the others: every thread gets at least this many chunks, the
+    // second value when the maximum out-degree is more than skewed_degree_ratio times the average one
+    const unsigned int min_chunks_per_thread = 4, min_chunks_per_thread_skewed = 32;
+    const double skewed_degree_ratio = 64;
+
+    std::string to_string(engine e) {
+        switch (e) {
+            case engine::graph_by_row:
+                return "graph_by_row";
+            case engine::graph_bitmap:
+                return "graph_bitmap";
+            default:
+                return "graph";
+        }
+    }
+
+    graph_stats get_stats(const unsigned int &n, const std::vector<std::pair<unsigned int, unsigned int>> &edges) {
+        std::vector<unsigned int> out_degree(n, 0);
+        for (auto &edge: edges)
+            out_degree[edge.first]++;
+
+        graph_stats stats{};
+        stats.n = n;
+        stats.m = edges.size();
+        stats.density = n > 1 ? static_cast<double>(stats.m) / (static_cast<double>(n) * (n - 1)) : 0;
+        stats.dead_end_fraction = static_cast<double>(std::count(out_degree.begin(), out_degree.end(), 0)) / n;
+        stats.degree_skew = stats.m == 0 ? 0 : *std::max_element(out_degree.begin(), out_degree.end()) /
+                                               (static_cast<double>(stats.m) / n);
+
+        return stats;
+    }
+
+    // milliseconds per iteration of a trial run (tolerance 0, so that all the iterations are done)
+    template<typename G>
+    static double time_trial(const G &g, int n_thread, int chunk_size, unsigned int trial_iterations) {
+        std::vector<float> v(g.get_n(), static_cast<float>(1) / g.get_n());
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        if constexpr (std::is_same_v<G, graph_bitmap>)
+            g.par_page_rank(v, 0.85, trial_iterations, 0, n_thread); // rows of equal cost, static schedule only
+        else
+            g.par_page_rank(v, 0.85, trial_iterations, 0, n_thread, chunk_size);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        return std::chrono::duration<double, std::milli>(end - begin).count() / trial_iterations;
+    }
+
+    // threads first with the default chunk, then the chunk with the best number of threads
+    template<typename G>
+    static configuration tune_engine(const G &g, engine e, const graph_stats &stats, int max_n_threads,
+                                     unsigned int trial_iterations) {
+        configuration best;
+        best.e = e;
+        best.ms_per_iteration = -1;
+
+        std::vector<int> thread_counts;
+        for (int t = 1; t < max_n_threads; t *= 2)
+            thread_counts.push_back(t);
+        thread_counts.push_back(max_n_threads);
+
+        for (auto &n_thread: thread_counts) {
+            double ms = time_trial(g, n_thread, -1, trial_iterations);
+            if (best.ms_per_iteration < 0 || ms < best.ms_per_iteration) {
+                best.n_thread = n_thread;
+                best.ms_per_iteration = ms;
+            }
+        }
+
+        // the bitmap rows all cost the same, its schedule is static
+        if (e != engine::graph_bitmap && best.n_thread > 1) {
+            unsigned int min_chunks = best.n_thread * (stats.degree_skew > skewed_degree_ratio
+                                                       ? min_chunks_per_thread_skewed : min_chunks_per_thread);
+            for (int chunk_size: {16, 64, 256, 1024, 4096}) {
+                if (chunk_size > 16 && stats.n / chunk_size < min_chunks)
+                    break;
+
+                double ms = time_trial(g, best.n_thread, chunk_size, trial_iterations);
+                if (ms < best.ms_per_iteration) {
+                    best.chunk_size = chunk_size;
+                    best.ms_per_iteration = ms;
+                }
+            }
+        }
+
+        return best;
+    }
+
+    configuration tune(const unsigned int &n, const std::vector<std::pair<unsigned int, unsigned int>> &edges,
+                       int max_n_threads, unsigned int trial_iterations) {
+        // If max_n_threads is -1, use all available threads
+        if (max_n_threads == -1) {
+            max_n_threads = omp_get_max_threads();
+        }
+
+        // every candidate is built only while it is timed
+        graph_stats stats = get_stats(n, edges);
+
+        // dense graphs: only the bit matrix, the neighbour lists are never allocated
+        if (graph_bitmap::is_dense(n, stats.m)) {
+            graph_bitmap g_bitmap(n, edges);
+            return tune_engine(g_bitmap, engine::graph_bitmap, stats, max_n_threads, trial_iterations);
+        }
+
+        configuration best;
+        {
+            graph g(n, edges);
+            best = tune_engine(g, engine::graph, stats, max_n_threads, trial_iterations);
+        }
+
+        double dead_end_work = stats.dead_end_fraction * static_cast<double>(stats.n) * stats.n;
+        if (dead_end_work <= max_dead_end_work_ratio * static_cast<double>(stats.m)) {
+            graph_by_row g_by_row(n, edges);
+            configuration by_row = tune_engine(g_by_row, engine::graph_by_row, stats, max_n_threads, trial_iterations);
+            if (by_row.ms_per_iteration < best.ms_per_iteration)
+                best = by_row;
+        }
+
+        return best;
+    }
+
+    bool load(const std::string &cache_file, uint64_t fingerprint, int max_n_threads, configuration &c) {
+        std::ifstream file(cache_file);
+        std::string line, e;
+        while (std::getline(file, line)) {
+            std::stringstream sline(line);
+            uint64_t line_fingerprint;
+            int line_max_n_threads;
+            configuration line_configuration;
+            sline >> line_fingerprint >> line_max_n_threads >> e >> line_configuration.n_thread
+                  >> line_configuration.chunk_size >> line_configuration.ms_per_iteration;
+            if (sline.fail() || line_fingerprint != fingerprint || line_max_n_threads != max_n_threads)
+                continue;
+
+            line_configuration.e = engine::graph;
+            for (engine candidate: {engine::graph_by_row, engine::graph_bitmap}) {
+                if (e == to_string(candidate))
+                    line_configuration.e = candidate;
+            }
+            c = line_configuration;
+            return true;
+        }
+
+        return false;
+    }
+
+    void save(const std::string &cache_file, uint64_t fingerprint, int max_n_threads, const configuration &c) {
+        // keep the lines of the other graphs and thread limits
+        std::vector<std::string> lines;
+        std::ifstream in(cache_file);
+        std::string line;
+        while (std::getline(in, line)) {
+            std::stringstream sline(line);
+            uint64_t line_fingerprint;
+            int line_max_n_threads;
+            sline >> line_fingerprint >> line_max_n_threads;
+            if (!line.empty() &&
+                (sline.fail() || line_fingerprint != fingerprint || line_max_n_threads != max_n_threads))
+                lines.push_back(line);
+        }
+        in.close();
+
+        std::ofstream file(cache_file);
+        if (!file.is_open()) {
+            std::cerr << "Error: cannot open file " << cache_file << std::endl;
+            return;
+        }
+
+        for (auto &l: lines)
+            file << l << std::endl;
+        file << fingerprint << " " << max_n_threads << " " << to_string(c.e) << " " << c.n_thread << " "
+             << c.chunk_size << " " << c.ms_per_iteration << std::endl;
+    }
+
+    configuration
+    get_configuration(const unsigned int &n, const std::vector<std::pair<unsigned int, unsigned int>> &edges,
+                      const std::string &cache_file, int max_n_threads) {
+        // If max_n_threads is -1, use all available threads
+        if (max_n_threads == -1) {
+            max_n_threads = omp_get_max_threads();
+        }
+
+        configuration c;
+        uint64_t fingerprint = graph::get_fingerprint(n, edges);
+        if (load(cache_file, fingerprint, max_n_threads, c))
+            return c;
+
+        c = tune(n, edges, max_n_threads);
+        save(cache_file, fingerprint, max_n_threads, c);
+
+        return c;
+    }
+}
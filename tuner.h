@@ -0,0 +1,54 @@
+#ifndef ASSIGNMENT_1_LMD_TUNER_H
+#define ASSIGNMENT_1_LMD_TUNER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// chooses the PageRank engine, number of threads and schedule chunk for a graph by timing short trial runs
+namespace tuner {
+    enum class engine {
+        graph, graph_by_row, graph_bitmap
+    };
+
+    struct graph_stats {
+        size_t n;
+        size_t m;
+        double density;
+        double dead_end_fraction;
+        double degree_skew; // maximum out-degree over the average one
+    };
+
+    struct configuration {
+        engine e = engine::graph;
+        int n_thread = 1;
+        int chunk_size = -1;
+        double ms_per_iteration = 0;
+    };
+
+    // computed from the edge list, without building any engine
+    graph_stats get_stats(const unsigned int &n, const std::vector<std::pair<unsigned int, unsigned int>> &edges);
+
+    // each candidate engine is built only while it is timed. Dense graphs (graph_bitmap::is_dense) only try
+    // graph_bitmap, so that the neighbour lists are never allocated; otherwise graph_by_row is only tried when its
+    // dead-end sweep (n times the number of dead ends per iteration) is not much more expensive than the edges
+    // themselves. The chunk sizes tried leave every thread enough chunks to balance the load, more with skewed degrees.
+    // Trial runs do trial_iterations iterations each
+    configuration tune(const unsigned int &n, const std::vector<std::pair<unsigned int, unsigned int>> &edges,
+                       int max_n_threads = -1, unsigned int trial_iterations = 3);
+
+    // cache file with a line "<fingerprint> <max_n_threads> <engine> <n_thread> <chunk_size> <ms_per_iteration>" per
+    // graph and thread limit, so that a configuration is never reused with more threads than it was tuned for
+    bool load(const std::string &cache_file, uint64_t fingerprint, int max_n_threads, configuration &c);
+
+    void save(const std::string &cache_file, uint64_t fingerprint, int max_n_threads, const configuration &c);
+
+    // cached configuration of the graph for max_n_threads if any, otherwise tune and save it
+    configuration
+    get_configuration(const unsigned int &n, const std::vector<std::pair<unsigned int, unsigned int>> &edges,
+                      const std::string &cache_file, int max_n_threads = -1);
+
+    std::string to_string(engine e);
+}
+
+#endif //ASSIGNMENT_1_LMD_TUNER_H
@@ -15,9 +15,16 @@
 namespace utility {
     std::vector<std::pair<unsigned int, unsigned int>>
     parse_edges_from_file_and_normalize(const std::string &filename) {
+        std::vector<unsigned int> original_ids;
+        return parse_edges_from_file_and_normalize(filename, original_ids);
+    }
+
+    std::vector<std::pair<unsigned int, unsigned int>>
+    parse_edges_from_file_and_normalize(const std::string &filename, std::vector<unsigned int> &original_ids) {
         std::unordered_map<unsigned int, unsigned int> map;
         std::vector<std::pair<unsigned int, unsigned int>> edges;
         std::ifstream file(filename);
+        original_ids.clear();
         // std::ofstream new_file{"../graphs/normalized_twitter_combined.txt"};
 
         unsigned int last_id = 0, u, v;
@@ -34,11 +41,15 @@ namespace utility {
                 if (sline.fail())
                     continue;
 
-                if (!map.contains(u))
+                if (!map.contains(u)) {
                     map[u] = last_id++;
+                    original_ids.push_back(u);
+                }
 
-                if (!map.contains(v))
+                if (!map.contains(v)) {
                     map[v] = last_id++;
+                    original_ids.push_back(v);
+                }
 
                 edges.emplace_back(map[u], map[v]);
 
@@ -62,6 +73,10 @@ namespace utility {
         return round(std::accumulate(r.begin(), r.end(), 0.0), 3) == 1;
     }
 
+    bool check_distribution(const std::vector<double> &r) {
+        return round(std::accumulate(r.begin(), r.end(), 0.0), 3) == 1;
+    }
+
     bool compare_vectors(const std::vector<float> &v1, const std::vector<float> &v2, double tolerance) {
         if (v1.size() != v2.size())
             return false;
@@ -133,4 +148,33 @@ namespace utility {
 
         return stats;
     }
-}
+
+    std::unordered_map<std::string, std::vector<std::pair<double, double>>> get_stats_pagerank(const graph_bitmap &g,
+                                                                                               int max_n_threads,
+                                                                                               unsigned int times) {
+        // compute speedup
+        std::unordered_map<std::string, std::vector<std::pair<double, double>>> stats;
+        std::vector<float> v(g.get_n(), static_cast<float>(1) / g.get_n());
+        unsigned int n_threads = max_n_threads == -1 ? omp_get_max_threads() : max_n_threads;
+        for (unsigned int i = 1; i <= n_threads; i++) {
+            long double mean = 0;
+            for (unsigned int k = 0; k < times; ++k) {
+                if (i == 1) {
+                    auto begin = std::chrono::high_resolution_clock::now();
+                    g.seq_page_rank(v, 0.85, 50, 1e-7);
+                    auto end = std::chrono::high_resolution_clock::now();
+                    mean += std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count();
+                } else {
+                    auto begin = std::chrono::high_resolution_clock::now();
+                    g.par_page_rank(v, 0.85, 50, 1e-7, i);
+                    auto end = std::chrono::high_resolution_clock::now();
+                    mean += std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count();
+                }
+            }
+
+            stats["pagerank_speedup"].emplace_back(i, mean / times);
+        }
+
+        return stats;
+    }
+}
\ No newline at end of file
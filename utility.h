@@ -8,15 +8,22 @@
 #include <unordered_map>
 #include "graph/graph.h"
 #include "graph/graph_by_row.h"
+#include "graph/graph_bitmap.h"
 
 namespace utility {
     std::vector<std::pair<unsigned int, unsigned int>>
     parse_edges_from_file_and_normalize(const std::string &filename);
 
+    // same as above, original_ids[i] is the id in the file of the normalized node i
+    std::vector<std::pair<unsigned int, unsigned int>>
+    parse_edges_from_file_and_normalize(const std::string &filename, std::vector<unsigned int> &original_ids);
+
     double round(double x, unsigned int d);
 
     bool check_distribution(const std::vector<float> &r);
 
+    bool check_distribution(const std::vector<double> &r);
+
     bool compare_vectors(const std::vector<float> &v1, const std::vector<float> &v2, double tolerance = 1e-4);
 
     std::unordered_map<std::string, std::vector<std::pair<double, double>>>
@@ -24,6 +31,9 @@ namespace utility {
 
     std::unordered_map<std::string, std::vector<std::pair<double, double>>>
     get_stats_pagerank(const graph_by_row &g, int max_n_threads, unsigned int times = 5);
+
+    std::unordered_map<std::string, std::vector<std::pair<double, double>>>
+    get_stats_pagerank(const graph_bitmap &g, int max_n_threads, unsigned int times = 5);
 }
 
 #endif //ASSIGNMENT_1_LMD_UTILITY_H